@@ -0,0 +1,581 @@
+#include <iostream>
+#include "articles.h"
+
+using namespace std;
+
+//Deterministic random numbers (splitmix64), so a seed gives the same corpus on every platform and compiler.
+class CorpusRandom
+{
+    public:
+        explicit CorpusRandom(uint64_t seed) : state(seed) {}
+
+        uint64_t next()
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        //Uniform in [0, n).
+        uint64_t uniform(uint64_t n)
+        {
+            return n == 0 ? 0 : next() % n;
+        }
+
+        //True with probability percent / 100.
+        bool chance(unsigned percent)
+        {
+            return uniform(100) < percent;
+        }
+
+    private:
+        uint64_t state;
+};
+
+struct GeneratorOptions
+{
+    size_t rows = 100000;
+    uint64_t seed = 42;
+    size_t averageWords = 400; //ISOT articles average roughly 400 words (~2.4 KB).
+};
+
+//Days since 1970-01-01 to a calendar date (proleptic Gregorian).
+void civil_from_days(long days, int& year, int& month, int& day)
+{
+    days += 719468;
+    long era = (days >= 0 ? days : days - 146096) / 146097;
+    long dayOfEra = days - era * 146097;
+    long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long mp = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+//Write a merge.csv-shaped file: Title,Content,Category,Date,Label with true rows first and then fake rows, each
+//mostly chronological. Word frequencies follow a Zipf-like curve, content lengths have a long tail, titles
+//sometimes contain commas, contents are quoted and sometimes contain doubled quotes or newlines, and both date
+//formats ("January 15, 2016 " and "8-Dec-17") appear.
+void generate_corpus(const string& filename, const GeneratorOptions& options)
+{
+    static const char* const commonWords[] = {
+        "the", "to", "of", "a", "and", "in", "that", "on", "for", "is", "said", "he", "trump", "with", "was", "it",
+        "as", "his", "by", "has", "be", "have", "not", "from", "at", "this", "who", "are", "an", "they", "president",
+        "would", "but", "we", "will", "people", "i", "been", "about", "their", "state", "government", "also", "which",
+        "clinton", "more", "new", "had", "after", "republican", "were", "house", "one", "than", "campaign", "obama",
+        "there", "white", "if", "all", "or", "election", "can", "united", "news", "states", "reuters", "party",
+        "told", "percent", "democratic", "security", "court", "washington", "police", "senate", "officials", "law",
+        "country", "military", "north", "russia", "media", "vote", "bill", "tax", "former", "week", "administration",
+        "foreign", "minister", "policy", "congress", "korea", "china", "department", "federal", "national", "public" };
+    const size_t commonCount = sizeof(commonWords) / sizeof(commonWords[0]);
+    const size_t vocabularySize = 20000;
+
+    // Vocabulary: the common words, then made-up words for the long tail.
+    vector<string> vocabulary(commonWords, commonWords + commonCount);
+    static const char* const syllables[] = { "ka", "lo", "mi", "ren", "tor", "sa", "vin", "qu", "est", "ion", "bel", "dra" };
+    for (size_t i = commonCount; i < vocabularySize; i++)
+    {
+        string word;
+        for (size_t n = i; word.empty() || n > 0; n /= 12)
+        {
+            word += syllables[n % 12];
+        }
+        vocabulary.push_back(word);
+    }
+
+    // Zipf weights 1/rank as an integer cumulative table.
+    vector<uint64_t> cumulative(vocabularySize);
+    uint64_t total = 0;
+    for (size_t rank = 0; rank < vocabularySize; rank++)
+    {
+        total += 1000000000ULL / (rank + 1);
+        cumulative[rank] = total;
+    }
+
+    CorpusRandom random(options.seed);
+    auto randomWord = [&]() -> const string&
+    {
+        uint64_t pick = random.uniform(total);
+        return vocabulary[upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin()];
+    };
+
+    static const char* const monthNames[] = { "January", "February", "March", "April", "May", "June", "July",
+                                              "August", "September", "October", "November", "December" };
+    struct CategoryShare { const char* name; unsigned share; };
+    static const CategoryShare trueCategories[] = { { "politicsNews", 53 }, { "worldnews", 47 } };
+    static const CategoryShare fakeCategories[] = { { "News", 39 }, { "politics", 29 }, { "left-news", 19 },
+                                                    { "Government News", 7 }, { "US_News", 3 }, { "Middle-east", 3 } };
+
+    ofstream out(filename, ios::binary);
+    if (!out.is_open())
+    {
+        throw runtime_error("Failed to open " + filename + " for writing.");
+    }
+    out << "Title,Content,Category,Date,Label\n";
+
+    const size_t trueRows = options.rows * 47 / 100;
+    string row, content;
+    for (size_t i = 0; i < options.rows; i++)
+    {
+        bool isTrue = i < trueRows;
+        size_t sectionRow = isTrue ? i : i - trueRows;
+        size_t sectionSize = isTrue ? trueRows : options.rows - trueRows;
+
+        // Dates advance with the row (true: 2016-01-13..2017-12-31, fake: 2015-03-31..2018-02-19) with a little jitter.
+        long firstDay = isTrue ? 16813 : 16525;
+        long lastDay = isTrue ? 17531 : 17581;
+        long dayNumber = firstDay + static_cast<long>((lastDay - firstDay) * sectionRow / max<size_t>(sectionSize, 1));
+        if (random.chance(20)) dayNumber -= static_cast<long>(random.uniform(4));
+        int year, month, day;
+        civil_from_days(dayNumber, year, month, day);
+
+        string date;
+        unsigned format = static_cast<unsigned>(random.uniform(100));
+        if (isTrue || format < 70)
+        {
+            date = string(monthNames[month - 1]) + " " + to_string(day) + ", " + to_string(year) + (isTrue ? " " : "");
+        }
+        else if (format < 80)
+        {
+            date = string(monthNames[month - 1]).substr(0, 3) + " " + to_string(day) + ", " + to_string(year);
+        }
+        else
+        {
+            date = to_string(day) + "-" + string(monthNames[month - 1]).substr(0, 3) + "-" + to_string(year % 100);
+        }
+
+        const CategoryShare* categories = isTrue ? trueCategories : fakeCategories;
+        size_t categoryCount = isTrue ? 2 : 6;
+        unsigned pick = static_cast<unsigned>(random.uniform(100));
+        size_t c = 0;
+        while (c + 1 < categoryCount && pick >= categories[c].share)
+        {
+            pick -= categories[c].share;
+            c++;
+        }
+
+        // Title: 6-16 words, sometimes with a comma (so the field must be quoted).
+        string title;
+        size_t titleWords = 6 + random.uniform(11);
+        for (size_t w = 0; w < titleWords; w++)
+        {
+            if (w > 0) title += (w == titleWords / 2 && random.chance(15)) ? ", " : " ";
+            title += randomWord();
+        }
+        title[0] = static_cast<char>(toupper(static_cast<unsigned char>(title[0])));
+
+        // Content: long-tailed length, sentences, occasional quotes and line breaks.
+        size_t words = options.averageWords / 2 + random.uniform(options.averageWords / 2 + 1);
+        if (random.chance(10)) words += random.uniform(options.averageWords * 4 + 1);
+        content.clear();
+        for (size_t w = 0; w < words; w++)
+        {
+            if (w > 0)
+            {
+                if (w % 17 == 0) content += random.chance(3) ? ".\n" : ". ";
+                else if (w % 7 == 0) content += ", ";
+                else content += ' ';
+            }
+            if (random.chance(1))
+            {
+                content += "\"\"" + randomWord() + "\"\"";
+            }
+            else
+            {
+                content += randomWord();
+            }
+        }
+        content += '.';
+
+        row.clear();
+        if (title.find(',') != string::npos)
+        {
+            row += '"';
+            row += title;
+            row += '"';
+        }
+        else
+        {
+            row += title;
+        }
+        row += ",\"";
+        row += content;
+        row += "\",";
+        row += categories[c].name;
+        row += ",\"";
+        row += date;
+        row += "\",";
+        row += isTrue ? "True" : "Fake";
+        row += '\n';
+        out.write(row.data(), row.size());
+    }
+}
+
+//Discards everything written to it; used to silence the query reports while timing them.
+class NullBuffer : public streambuf
+{
+    protected:
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+//Query results are stored here so the optimizer cannot drop a query whose result is otherwise unused.
+volatile double benchmarkSink;
+
+//Nearest-rank percentile of already sorted samples.
+double percentile(const vector<double>& sorted, double p)
+{
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(p / 100.0 * sorted.size() + 0.999999);
+    return sorted[min(max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+struct StageResult
+{
+    string name;
+    vector<double> milliseconds;
+    long long rssDelta;
+    size_t rows;
+    uint64_t allocations;    //Per run; only counted in NEWS_COUNT_ALLOCATIONS builds.
+    uint64_t allocatedBytes;
+};
+
+//Run a stage repetitions times, each as its own profiler phase, and summarize it.
+template <typename F>
+StageResult run_stage(const string& name, size_t rows, size_t repetitions, F stage)
+{
+    StageResult result = { name, {}, 0, rows, 0, 0 };
+    for (size_t i = 0; i < repetitions; i++)
+    {
+        {
+            PhaseTimer phase(name);
+            stage();
+        }
+        const PhaseRecord* record = profiler().find(name);
+        result.milliseconds.push_back(record->milliseconds);
+        result.rssDelta = max(result.rssDelta, static_cast<long long>(record->rssAfter) - static_cast<long long>(record->rssBefore));
+        result.allocations = record->allocations;
+        result.allocatedBytes = record->allocatedBytes;
+    }
+    sort(result.milliseconds.begin(), result.milliseconds.end());
+    return result;
+}
+
+void print_stage(const StageResult& stage)
+{
+    double p50 = percentile(stage.milliseconds, 50);
+    cout << left << setw(26) << stage.name << right << fixed << setprecision(2)
+         << setw(11) << p50
+         << setw(11) << percentile(stage.milliseconds, 90)
+         << setw(11) << percentile(stage.milliseconds, 99)
+         << setw(14) << setprecision(0) << (p50 > 0 ? stage.rows / (p50 / 1000.0) : 0.0)
+         << setw(12) << stage.rssDelta / 1024;
+    if (Profiler::allocationCountingEnabled())
+    {
+        double rows = static_cast<double>(max<size_t>(stage.rows, 1));
+        cout << setw(12) << setprecision(2) << stage.allocations / rows
+             << setw(12) << setprecision(0) << stage.allocatedBytes / rows;
+    }
+    cout << endl;
+}
+
+//Append a copy of every article of source to target (whose fields may be views into source).
+template <typename Target>
+void copy_articles(const LinkedList<string>& source, Target& target)
+{
+    for (Article<string>* node = source.getHead(); node; node = node->next)
+    {
+        target.emplace_back(node->Title, node->Content, node->Category, node->Date, node->Label, node->DateKey);
+    }
+}
+
+void print_usage()
+{
+    cout << "Usage: Benchmark [--rows N] [--reps N] [--seed N] [--words N] [--threads N] [--file PATH] [--keep]\n"
+         << "  --rows     rows to generate (default 100000)\n"
+         << "  --reps     repetitions per query for latency percentiles (default 10)\n"
+         << "  --seed     generator seed (default 42)\n"
+         << "  --words    average words per article (default 400)\n"
+         << "  --threads  threads for the parallel import, sort and export stages (default: hardware threads)\n"
+         << "  --file     corpus path (default bench_merge.csv)\n"
+         << "  --keep     reuse an existing corpus file instead of regenerating it\n";
+}
+
+int main(int argc, char* argv[])
+{
+    GeneratorOptions options;
+    size_t repetitions = 10;
+    unsigned threads = max(thread::hardware_concurrency(), 1u);
+    string corpusFile = "bench_merge.csv";
+    bool keep = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--keep") keep = true;
+        else if (arg == "--rows" && hasValue) options.rows = stoull(argv[++i]);
+        else if (arg == "--reps" && hasValue) repetitions = max<size_t>(stoull(argv[++i]), 1);
+        else if (arg == "--seed" && hasValue) options.seed = stoull(argv[++i]);
+        else if (arg == "--words" && hasValue) options.averageWords = max<size_t>(stoull(argv[++i]), 1);
+        else if (arg == "--threads" && hasValue) threads = max<unsigned>(static_cast<unsigned>(stoul(argv[++i])), 1u);
+        else if (arg == "--file" && hasValue) corpusFile = argv[++i];
+        else
+        {
+            print_usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    try
+    {
+        if (!keep || !ifstream(corpusFile).good())
+        {
+            PhaseTimer phase("generate");
+            generate_corpus(corpusFile, options);
+        }
+
+        vector<StageResult> results;
+        NullBuffer nullBuffer;
+        streambuf* console = cout.rdbuf();
+
+        // Load stages: each runs once on a fresh list; the last parallel import is the one that is kept.
+        LinkedList<string> newsList;
+        {
+            LinkedList<string> serialList;
+            results.push_back(run_stage("import_serial", 0, 1, [&]() { import_csv_to_linkedlist(corpusFile, serialList); }));
+            results.back().rows = serialList.getSize();
+        }
+        results.push_back(run_stage("import_parallel", 0, 1, [&]()
+        {
+            vector<ImportReject> rejects;
+            import_csv_to_linkedlist(corpusFile, newsList, rejects, threads);
+        }));
+        size_t rows = newsList.getSize();
+        results.back().rows = rows;
+
+        {
+            // The parallel and radix sorts each get their own copy of the unsorted data.
+            LinkedList<string> parallelList;
+            import_csv_to_linkedlist(corpusFile, parallelList);
+            ThreadPool pool(threads);
+            ParallelMergeSort parallelSorter;
+            results.push_back(run_stage("sort_parallel", rows, 1, [&]() { parallelSorter.sort(parallelList, pool); }));
+        }
+        {
+            LinkedList<string> radixList;
+            import_csv_to_linkedlist(corpusFile, radixList);
+            RadixSort radixSorter;
+            results.push_back(run_stage("sort_radix", rows, 1, [&]() { radixSorter.radixSort(radixList); }));
+        }
+        TimSort timSorter;
+        results.push_back(run_stage("sort_timsort", rows, 1, [&]() { timSorter.timSort(newsList); }));
+
+        cout.rdbuf(&nullBuffer);
+        // Old outputs are deleted first: truncating a large file that is still being written back can cost more
+        // than writing it.
+        remove("bench_sorted.csv");
+        results.push_back(run_stage("export_csv", rows, 1, [&]() { save_sorted_data_to_csv(newsList, "bench_sorted.csv"); }));
+        remove("bench_sorted.csv");
+        results.push_back(run_stage("export_csv_parallel", rows, 1, [&]() { save_sorted_data_to_csv(newsList, "bench_sorted.csv", threads); }));
+        cout.rdbuf(console);
+
+        InvertedIndex keywordIndex;
+        results.push_back(run_stage("build_inverted_index", rows, 1, [&]() { keywordIndex.build(newsList); }));
+
+        DateIndex dateIndex;
+        results.push_back(run_stage("build_date_index", rows, 1, [&]() { dateIndex.build(newsList); }));
+
+        // Snapshot of the sorted table: write once, then time the startup path that maps it back in.
+        ArticleTable sortedTable = ArticleTable::fromList(newsList);
+        remove("bench.snapshot");
+        results.push_back(run_stage("snapshot_write", rows, 1, [&]() { sortedTable.saveSnapshot("bench.snapshot", 0, 0); }));
+        ArticleTable snapshotTable;
+        results.push_back(run_stage("snapshot_load", rows, repetitions, [&]() { snapshotTable = ArticleTable::loadSnapshot("bench.snapshot"); }));
+
+        // Query stages: repeated for latency percentiles, with their console output discarded.
+        LinearSearch searcher;
+        cout.rdbuf(&nullBuffer);
+        results.push_back(run_stage("query_count_news", rows, repetitions, [&]() { searcher.countNews(newsList); }));
+        results.push_back(run_stage("query_fake_political_2016", rows, repetitions, [&]() { benchmarkSink = searcher.percentageFakePolitical2016(newsList); }));
+        results.push_back(run_stage("query_top10_words", rows, repetitions, [&]() { searcher.top10FrequentWordsInGovernmentFakeNews(newsList); }));
+        results.push_back(run_stage("query_fake_by_month", rows, repetitions, [&]() { searcher.percentageFakePoliticalByMonth(newsList); }));
+        results.push_back(run_stage("date_index_fake_pol_2016", rows, repetitions, [&]() { benchmarkSink = searcher.percentageFakePolitical2016(dateIndex); }));
+        results.push_back(run_stage("date_index_fake_by_month", rows, repetitions, [&]() { searcher.percentageFakePoliticalByMonth(dateIndex); }));
+        results.push_back(run_stage("query_fused_report", rows, repetitions, [&]()
+        {
+            // Items 1, 2 and 4 above, evaluated in one traversal.
+            AnalyticsEngine report;
+            AnalyticsFilter fakeOnly, political2016;
+            fakeOnly.label = LABEL_FAKE;
+            political2016.year = 2016;
+            political2016.politicalOnly = true;
+            report.addCount("news_by_label", AnalyticsFilter(), GROUP_LABEL);
+            report.addRatio("fake_political_2016", political2016, fakeOnly);
+            report.addRatio("fake_political_2016_by_month", political2016, fakeOnly, GROUP_MONTH);
+            benchmarkSink = report.run(newsList).size();
+        }));
+        results.push_back(run_stage("query_report_snapshot", rows, repetitions, [&]()
+        {
+            AnalyticsEngine report;
+            AnalyticsFilter fakeOnly, political2016;
+            fakeOnly.label = LABEL_FAKE;
+            political2016.year = 2016;
+            political2016.politicalOnly = true;
+            report.addCount("news_by_label", AnalyticsFilter(), GROUP_LABEL);
+            report.addRatio("fake_political_2016", political2016, fakeOnly);
+            report.addRatio("fake_political_2016_by_month", political2016, fakeOnly, GROUP_MONTH);
+            benchmarkSink = report.run(snapshotTable).size();
+        }));
+        results.push_back(run_stage("query_keyword_linear", rows, repetitions, [&]()
+        {
+            benchmarkSink = searcher.findArticlesLinear(newsList, "election", "politicsNews", 2016, SIZE_MAX).size();
+        }));
+        results.push_back(run_stage("date_index_keyword_linear", rows, repetitions, [&]()
+        {
+            benchmarkSink = searcher.findArticlesLinear(dateIndex, "election", "politicsNews", 2016, SIZE_MAX).size();
+        }));
+        // Watch list: 100 distinct words taken from the corpus, searched one by one and then in one batch.
+        vector<string> watchList;
+        for (Article<string>* node = newsList.getHead(); node && watchList.size() < 100; node = node->next)
+        {
+            InvertedIndex::forEachToken(node->Content, [&](const string& token)
+            {
+                if (watchList.size() < 100 && token.size() > 3 && find(watchList.begin(), watchList.end(), token) == watchList.end())
+                {
+                    watchList.push_back(token);
+                }
+            });
+        }
+        results.push_back(run_stage("watchlist_linear_x100", rows, repetitions, [&]()
+        {
+            size_t hits = 0;
+            for (const string& keyword : watchList)
+            {
+                hits += searcher.findArticlesLinear(newsList, keyword, "politicsNews", 2016, SIZE_MAX).size();
+            }
+            benchmarkSink = hits;
+        }));
+        results.push_back(run_stage("watchlist_aho_corasick", rows, repetitions, [&]()
+        {
+            benchmarkSink = searcher.findArticlesBatch(newsList, watchList, "politicsNews", 2016).size();
+        }));
+        results.push_back(run_stage("query_keyword_indexed", rows, repetitions, [&]()
+        {
+            benchmarkSink = searcher.findArticles(keywordIndex, { "election" }, true, "politicsNews", 2016, SIZE_MAX).size();
+        }));
+        cout.rdbuf(console);
+
+        // Space-Saving top words and n-grams in fixed memory: the words of fake government news (against the exact
+        // query_top10_words), then bigrams and trigrams over every article.
+        AnalyticsFilter governmentFake;
+        governmentFake.category = "Government News";
+        governmentFake.label = LABEL_FAKE;
+        results.push_back(run_stage("heavy_hitters_words", rows, repetitions, [&]()
+        {
+            NgramHeavyHitters hitters(1, 1024, governmentFake);
+            hitters.addAll(newsList);
+            benchmarkSink = hitters.topK(10).size();
+        }));
+        for (size_t n = 2; n <= 3; n++)
+        {
+            results.push_back(run_stage(n == 2 ? "heavy_hitters_bigrams" : "heavy_hitters_trigrams", rows, 1, [&]()
+            {
+                NgramHeavyHitters hitters(n, 4096);
+                hitters.addAll(newsList);
+                benchmarkSink = hitters.topK(10).size();
+            }));
+        }
+
+        // The sorted articles copied into an unrolled list: the same scan over contiguous blocks, and positional
+        // access through the block index instead of a walk from the head.
+        UnrolledList<string> unrolledList;
+        results.push_back(run_stage("build_unrolled_list", rows, 1, [&]()
+        {
+            for (Article<string>* node = newsList.getHead(); node; node = node->next)
+            {
+                unrolledList.emplace_back(node->Title, node->Content, node->Category, node->Date, node->Label, node->DateKey);
+            }
+        }));
+        cout.rdbuf(&nullBuffer);
+        results.push_back(run_stage("query_count_news_unrolled", rows, repetitions, [&]() { searcher.countNews(unrolledList); }));
+        cout.rdbuf(console);
+        const size_t positionalReads = 1000;
+        results.push_back(run_stage("get_x1000_linked_list", positionalReads, 1, [&]()
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < positionalReads; i++) sum += newsList.get(i * rows / positionalReads)->DateKey;
+            benchmarkSink = sum;
+        }));
+        results.push_back(run_stage("get_x1000_unrolled_list", positionalReads, repetitions, [&]()
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < positionalReads; i++) sum += unrolledList.get(i * rows / positionalReads)->DateKey;
+            benchmarkSink = sum;
+        }));
+
+        // Node allocator policies: the sorted articles copied into a list that news/deletes every node and into the
+        // default pooled list, each torn down before the next is built so both free into the same heap state.
+        // Pooled string articles still run one destructor per node; articles of string_views (views into newsList)
+        // are trivially destructible, so their pool releases its blocks without walking the chain.
+        size_t heapNodeAllocations = 0, poolNodeAllocations = 0;
+        {
+            LinkedList<string, HeapNodeAllocator<string>> heapList;
+            results.push_back(run_stage("copy_list_heap_nodes", rows, 1, [&]() { copy_articles(newsList, heapList); }));
+            heapNodeAllocations = heapList.getAllocator().allocationCount();
+            results.push_back(run_stage("teardown_heap_nodes", rows, 1, [&]() { heapList.clear(); }));
+        }
+        {
+            LinkedList<string> poolList;
+            results.push_back(run_stage("copy_list_pool_nodes", rows, 1, [&]() { copy_articles(newsList, poolList); }));
+            poolNodeAllocations = poolList.getAllocator().allocationCount();
+            results.push_back(run_stage("teardown_pool_nodes", rows, 1, [&]() { poolList.clear(); }));
+        }
+        {
+            LinkedList<string_view> viewList;
+            copy_articles(newsList, viewList);
+            results.push_back(run_stage("teardown_pool_views", rows, 1, [&]() { viewList.clear(); }));
+        }
+
+        // Incremental ingest of a batch 1/20 the corpus size, merged into the sorted list with both indexes
+        // updated. The batch spans the corpus' whole date range, the worst case for the merge. Runs last because
+        // it changes the list.
+        GeneratorOptions batchOptions = options;
+        batchOptions.rows = max<size_t>(options.rows / 20, 1);
+        batchOptions.seed = options.seed + 1;
+        generate_corpus("bench_batch.csv", batchOptions);
+        vector<ImportReject> batchRejects;
+        results.push_back(run_stage("append_batch", batchOptions.rows, 1, [&]()
+        {
+            benchmarkSink = append_batch("bench_batch.csv", newsList, batchRejects, &dateIndex, &keywordIndex, threads);
+        }));
+
+        cout << "Corpus: " << corpusFile << " (" << rows << " articles, seed " << options.seed << ")" << endl;
+        cout << left << setw(26) << "stage" << right << setw(11) << "p50 ms" << setw(11) << "p90 ms" << setw(11) << "p99 ms"
+             << setw(14) << "rows/s" << setw(12) << "RSS +KB";
+        if (Profiler::allocationCountingEnabled())
+        {
+            cout << setw(12) << "allocs/row" << setw(12) << "bytes/row";
+        }
+        cout << endl;
+        for (const StageResult& stage : results)
+        {
+            print_stage(stage);
+        }
+        cout << "Node allocations for " << rows << " articles: " << heapNodeAllocations << " heap, "
+             << poolNodeAllocations << " pooled" << endl;
+    }
+    catch (const exception& e)
+    {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    if (profiler().saveJson("benchmark_report.json"))
+    {
+        cout << "Per-run details saved to benchmark_report.json" << endl;
+    }
+    return 0;
+}
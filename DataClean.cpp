@@ -1,142 +1,36 @@
 #include <iostream>
-#include <string>
-#include <fstream>
-#include <sstream>
-#include <regex>
+#include "articles.h"
 
 using namespace std;
 
-void trim(string& str) 
-{
-    size_t start = str.find_first_not_of(" \t\n\r");
-    size_t end = str.find_last_not_of(" \t\n\r");
-    str = (start == string::npos) ? "" : str.substr(start, end - start + 1);
-}
-
-//Function to split csv file into a array.
-bool splitCSVLine(const string &line, string columns[], int &colCount, char delimiter = ',') 
-{
-    stringstream ss(line);
-    string value;
-    colCount = 0;
-
-    while (getline(ss, value, delimiter)) {
-        trim(value); // Remove spaces from the value
-        columns[colCount++] = value;
-
-        // Prevent exceeding the fixed-size array
-        if (colCount >= 4) break;
-    }
-    return (colCount == 4); // Ensure exactly 4 columns are read
-}
-
-//Function to remove empty rows from fake CSV file
-void remove_empty_row(const string& fakefile, const string& fakefiles)
+//Prepare merge.csv from the raw dataset in one pass: true.csv and fake.csv are each read once, rows with an
+//empty field are dropped, the True/Fake label is attached and the rows are streamed to merge.csv without keeping
+//the dataset in memory.
+//main can also ingest the sources directly (main --from-sources), in which case this step is not needed.
+int main()
 {
-    ifstream inputfile(fakefile);
-    ofstream outputfile(fakefiles);
+    string truefile = "true.csv";
+    string fakefile = "fake.csv";
+    string mergefile = "merge.csv";
 
-    if(!inputfile.is_open() || !outputfile.is_open())
+    size_t rows = 0;
+    vector<ImportReject> rejects;
+    try
     {
-        cout << "Failed to open the file to remove empty row." << endl;
-        return;
+        PhaseTimer phase("ingest_sources");
+        rows = write_merged_sources({ { truefile, "True" }, { fakefile, "Fake" } }, mergefile, rejects);
     }
-
-    string line;
-    bool fake_header = true;
-
-    while (getline(inputfile, line)) 
+    catch (const runtime_error& e)
     {
-        string columns[4];
-        int colCount = 0;
-
-        if(!splitCSVLine(line, columns, colCount)) continue;
-
-        if(fake_header)
-        {
-            outputfile << line << "\n" ;
-            fake_header = false;
-            continue;
-        }
-
-        bool empty_column = false;
-        for (int i = 0; i < colCount; i++) 
-        {
-            if (columns[i].empty()) 
-            {
-                empty_column = true;
-                break;
-            }
-        }
-
-        if (!empty_column) 
-        {
-            outputfile << line << "\n";
-        }
+        cerr << "Error: " << e.what() << endl;
+        return 1;
     }
-    inputfile.close();
-    outputfile.close();
-}
 
-void merge_csv(const string& truefile, const string& fakefiles, const string& mergefile)
-{
-    ifstream true_file(truefile);
-    ifstream fake_file(fakefiles);
-    ofstream merge_file(mergefile);
-    string line;
-
-    if(!true_file.is_open() || !fake_file.is_open() || !merge_file.is_open())
+    cout << "Mergefile is successfully created (" << rows << " rows, " << rejects.size() << " dropped, "
+         << profiler().find("ingest_sources")->milliseconds << " ms)." << endl;
+    for (size_t i = 0; i < rejects.size() && i < 10; i++)
     {
-        cout << "Failed to open the files." << endl;
-        return;
-    }
-    else
-    {
-        merge_file << "Title,Content,Category,Date,Label\n";
-
-        bool true_header = true;
-        while (getline(true_file, line))
-        {
-            if (true_header) 
-            { 
-                true_header = false;
-                continue;
-            }
-            merge_file << line << ",True\n";
-        }
-        true_file.close();
-        
-        bool fake_header = true;
-        while (getline(fake_file, line))
-        {
-            if (fake_header) 
-            { 
-                fake_header = false;
-                continue;
-            }
-            merge_file << line << ",Fake\n";
-        }
-        fake_file.close();
-
-        merge_file.close();
-
-        cout << "Mergefile is successfully created." << endl;
+        cerr << "  row " << rejects[i].row << ": " << rejects[i].reason << endl;
     }
-}
-
-int main()
-{
-    /*
-    string inputfile = "fake.csv";
-    string outputfile = "fakes.csv";
-    remove_empty_row(inputfile, outputfile);
-    */
-
-    string truefile = "true.csv";
-    string fakefile = "fakes.csv";
-    string mergefile = "merge.csv";
-    merge_csv(truefile, fakefile, mergefile);
-
-    
     return 0;
 }
@@ -0,0 +1,194 @@
+#ifndef AHOCORASICK_H
+#define AHOCORASICK_H
+
+#include "textsearch.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//Aho-Corasick automaton over a set of keywords, matched as ASCII case-insensitive substrings (the same matching
+//as CaseInsensitiveSearcher). All keywords are found in one pass over a text, whatever their number.
+//The failure links are resolved into a full transition table at build time, so scanning is one table lookup
+//per byte. The alphabet is compressed to the (folded) bytes that occur in the keywords plus one class for every
+//other byte, which keeps the table small for watch lists of hundreds of keywords.
+class KeywordAutomaton
+{
+    public:
+        //Empty keywords never match. Keywords equal after case folding are reported separately.
+        explicit KeywordAutomaton(const vector<string>& keywords) : keywords(keywords)
+        {
+            build();
+        }
+
+        size_t keywordCount() const
+        {
+            return keywords.size();
+        }
+
+        const string& keyword(size_t index) const
+        {
+            return keywords[index];
+        }
+
+        //Call f(keywordIndex, endOffset) for every occurrence of every keyword in text, in text order
+        //(overlapping occurrences included); endOffset is one past the last byte of the match.
+        template <typename F>
+        void forEachMatch(string_view text, F f) const
+        {
+            uint32_t state = 0;
+            for (size_t i = 0; i < text.size(); i++)
+            {
+                state = transitions[state * alphabetSize + byteClass[static_cast<unsigned char>(text[i])]];
+                for (uint32_t s = firstMatch[state]; s != NO_STATE; s = outputLink[s])
+                {
+                    for (uint32_t k = terminal[s]; k != NO_KEYWORD; k = sameKeyword[k])
+                    {
+                        f(k, i + 1);
+                    }
+                }
+            }
+        }
+
+        size_t stateCount() const
+        {
+            return terminal.size();
+        }
+
+        size_t memoryUsage() const
+        {
+            size_t bytes = sizeof(*this) + transitions.capacity() * sizeof(uint32_t)
+                         + (terminal.capacity() + outputLink.capacity() + firstMatch.capacity() + sameKeyword.capacity()) * sizeof(uint32_t);
+            for (const string& keyword : keywords)
+            {
+                bytes += keyword.capacity();
+            }
+            return bytes;
+        }
+
+    private:
+        static constexpr uint32_t NO_STATE = UINT32_MAX;
+        static constexpr uint32_t NO_KEYWORD = UINT32_MAX;
+
+        vector<string> keywords;
+        uint8_t byteClass[256] = {};   // Byte -> alphabet index (0 = a byte no keyword contains)
+        size_t alphabetSize = 1;
+        vector<uint32_t> transitions;  // State * alphabetSize + class -> next state
+        vector<uint32_t> terminal;     // State -> first keyword ending there, or NO_KEYWORD
+        vector<uint32_t> outputLink;   // State -> nearest proper suffix state that ends a keyword, or NO_STATE
+        vector<uint32_t> firstMatch;   // State -> itself if it ends a keyword, else outputLink (one load per byte)
+        vector<uint32_t> sameKeyword;  // Keyword -> next keyword ending in the same state
+
+        void build()
+        {
+            if (keywords.size() >= NO_KEYWORD)
+            {
+                throw length_error("KeywordAutomaton supports at most 2^32 - 1 keywords.");
+            }
+
+            // Alphabet: one class per folded byte that occurs in a keyword; both cases of a letter share it.
+            for (const string& keyword : keywords)
+            {
+                for (char c : keyword)
+                {
+                    unsigned char folded = static_cast<unsigned char>(fold_ascii(c));
+                    if (byteClass[folded] == 0)
+                    {
+                        if (alphabetSize > 255) throw length_error("KeywordAutomaton alphabet is full.");
+                        byteClass[folded] = static_cast<uint8_t>(alphabetSize++);
+                    }
+                }
+            }
+            for (int c = 'A'; c <= 'Z'; c++)
+            {
+                byteClass[c] = byteClass[c | 0x20];
+            }
+
+            // Trie. Missing edges are NO_STATE until the failure pass fills them in.
+            addState();
+            sameKeyword.assign(keywords.size(), NO_KEYWORD);
+            for (uint32_t k = 0; k < keywords.size(); k++)
+            {
+                if (keywords[k].empty()) continue;
+                uint32_t state = 0;
+                for (char c : keywords[k])
+                {
+                    uint32_t& next = transitions[state * alphabetSize + byteClass[static_cast<unsigned char>(c)]];
+                    if (next == NO_STATE)
+                    {
+                        uint32_t created = addState(); // May reallocate transitions: do not reuse next.
+                        transitions[state * alphabetSize + byteClass[static_cast<unsigned char>(c)]] = created;
+                        state = created;
+                    }
+                    else
+                    {
+                        state = next;
+                    }
+                }
+                sameKeyword[k] = terminal[state];
+                terminal[state] = k;
+            }
+
+            // Breadth-first: each state's failure target is already complete when the state is reached, so a
+            // missing edge can take the failure target's edge.
+            vector<uint32_t> failure(terminal.size(), 0);
+            queue<uint32_t> pending;
+            for (size_t c = 0; c < alphabetSize; c++)
+            {
+                uint32_t& next = transitions[c];
+                if (next == NO_STATE)
+                {
+                    next = 0;
+                }
+                else
+                {
+                    failure[next] = 0;
+                    pending.push(next);
+                }
+            }
+            while (!pending.empty())
+            {
+                uint32_t state = pending.front();
+                pending.pop();
+                uint32_t fail = failure[state];
+                outputLink[state] = terminal[fail] != NO_KEYWORD ? fail : outputLink[fail];
+                for (size_t c = 0; c < alphabetSize; c++)
+                {
+                    uint32_t& next = transitions[state * alphabetSize + c];
+                    if (next == NO_STATE)
+                    {
+                        next = transitions[fail * alphabetSize + c];
+                    }
+                    else
+                    {
+                        failure[next] = transitions[fail * alphabetSize + c];
+                        pending.push(next);
+                    }
+                }
+            }
+
+            firstMatch.resize(terminal.size());
+            for (size_t state = 0; state < terminal.size(); state++)
+            {
+                firstMatch[state] = terminal[state] != NO_KEYWORD ? static_cast<uint32_t>(state) : outputLink[state];
+            }
+        }
+
+        uint32_t addState()
+        {
+            if (terminal.size() >= NO_STATE - 1)
+            {
+                throw length_error("KeywordAutomaton has too many states.");
+            }
+            transitions.resize(transitions.size() + alphabetSize, NO_STATE);
+            terminal.push_back(NO_KEYWORD);
+            outputLink.push_back(NO_STATE);
+            return static_cast<uint32_t>(terminal.size() - 1);
+        }
+};
+
+#endif
@@ -0,0 +1,315 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include "linkedlist.h"
+#include "articletable.h"
+#include "dictionary.h"
+#include "dateindex.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+
+using namespace std;
+
+enum AnalyticsGroupBy { GROUP_NONE, GROUP_MONTH, GROUP_CATEGORY, GROUP_LABEL };
+
+//Which rows an aggregation looks at. Category and label comparisons ignore case and whitespace.
+struct AnalyticsFilter
+{
+    int year = 0;               // 0 = any year
+    int month = 0;              // 0 = any month
+    bool politicalOnly = false; // Category in the political class ("politics", "politicsNews")
+    string category;            // Empty = any category
+    ArticleLabel label = LABEL_ANY;
+};
+
+struct AnalyticsCounts
+{
+    uint64_t total = 0;    // Rows that passed the filter
+    uint64_t matching = 0; // ... and the numerator filter (ratios only; equals total for counts)
+
+    double percentage() const
+    {
+        return total == 0 ? 0.0 : static_cast<double>(matching) / total * 100;
+    }
+};
+
+struct AnalyticsGroup
+{
+    string key;    // Category (first spelling seen), label class ("true", "fake", "other") or month number
+    int month = 0; // Month groups only
+    AnalyticsCounts counts;
+};
+
+struct AnalyticsResult
+{
+    string name;
+    AnalyticsGroupBy groupBy;
+    AnalyticsCounts counts;
+    vector<AnalyticsGroup> groups; // Months 1-12 in order (all twelve), other keys alphabetically
+};
+
+//Evaluates any number of registered aggregations in one traversal. Each row is reduced once to its year, month,
+//category code and label class (the codes were interned at import) and then checked against every aggregation,
+//so adding a report costs a few integer comparisons per row rather than another pass over the list.
+class AnalyticsEngine
+{
+    public:
+        //Count the rows that pass filter, optionally per group. Returns the result index.
+        size_t addCount(const string& name, const AnalyticsFilter& filter, AnalyticsGroupBy groupBy = GROUP_NONE)
+        {
+            aggregations.push_back({ name, normalized(filter), AnalyticsFilter(), false, groupBy });
+            return aggregations.size() - 1;
+        }
+
+        //Share of the rows passing filter that also pass numerator, optionally per group.
+        size_t addRatio(const string& name, const AnalyticsFilter& filter, const AnalyticsFilter& numerator, AnalyticsGroupBy groupBy = GROUP_NONE)
+        {
+            aggregations.push_back({ name, normalized(filter), normalized(numerator), true, groupBy });
+            return aggregations.size() - 1;
+        }
+
+        size_t size() const
+        {
+            return aggregations.size();
+        }
+
+        void clear()
+        {
+            aggregations.clear();
+        }
+
+        //Results in registration order.
+        vector<AnalyticsResult> run(const LinkedList<string>& list) const
+        {
+            vector<Accumulator> accumulators = start();
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                accumulate(accumulators, node->DateKey, node->CategoryCode, node->LabelCode);
+            }
+            return results(accumulators);
+        }
+
+        //Columnar version: only the date key and code columns are read.
+        vector<AnalyticsResult> run(const ArticleTable& table) const
+        {
+            vector<Accumulator> accumulators = start();
+            for (ArticleTable::RowId row = 0; row < table.getSize(); row++)
+            {
+                accumulate(accumulators, table.dateKey(row), table.categoryCode(row), table.labelCode(row));
+            }
+            return results(accumulators);
+        }
+
+        //Same results from a date index built over a list: when every aggregation filters on a year (or year and
+        //month), only the date range covering those filters is visited.
+        vector<AnalyticsResult> run(const DateIndex& index) const
+        {
+            if (!index.hasArticles())
+            {
+                throw logic_error("AnalyticsEngine::run(DateIndex) needs an index built from a list.");
+            }
+            vector<Accumulator> accumulators = start();
+            DateIndex::Range range = dateRange(index);
+            for (size_t position = range.begin; position < range.end; position++)
+            {
+                const Article<string>* node = index.article(position);
+                accumulate(accumulators, node->DateKey, node->CategoryCode, node->LabelCode);
+            }
+            return results(accumulators);
+        }
+
+        //Columnar version of the above; index must have been built from table.
+        vector<AnalyticsResult> run(const ArticleTable& table, const DateIndex& index) const
+        {
+            vector<Accumulator> accumulators = start();
+            DateIndex::Range range = dateRange(index);
+            for (size_t position = range.begin; position < range.end; position++)
+            {
+                ArticleTable::RowId row = index.row(position);
+                accumulate(accumulators, index.dateKey(position), table.categoryCode(row), table.labelCode(row));
+            }
+            return results(accumulators);
+        }
+
+        static const char* label_name(ArticleLabel label)
+        {
+            switch (label)
+            {
+                case LABEL_TRUE: return "true";
+                case LABEL_FAKE: return "fake";
+                case LABEL_ANY: return "any";
+                default: return "other";
+            }
+        }
+
+        //True if a row passes filter. categoryFilter is the code of filter.category (-1 = any), categoryClass and
+        //label the classes of the row's codes.
+        static bool passes(const AnalyticsFilter& filter, int categoryFilter, int year, int month, int categoryCode, int categoryClass, int label)
+        {
+            return (filter.year == 0 || filter.year == year) &&
+                   (filter.month == 0 || filter.month == month) &&
+                   (!filter.politicalOnly || categoryClass == CATEGORY_POLITICAL) &&
+                   (categoryFilter < 0 || categoryFilter == categoryCode) &&
+                   (filter.label == LABEL_ANY || filter.label == label);
+        }
+
+    private:
+        struct Aggregation
+        {
+            string name;
+            AnalyticsFilter filter;
+            AnalyticsFilter numerator;
+            bool ratio;
+            AnalyticsGroupBy groupBy;
+        };
+
+        struct Accumulator
+        {
+            AnalyticsCounts counts;
+            AnalyticsCounts months[13]; // Index 0 collects keys without a valid month
+            AnalyticsCounts labels[3];
+            vector<AnalyticsCounts> categories; // By category code
+            int filterCategory;    // Code of filter.category: -1 = any, NOT_FOUND = matches nothing
+            int numeratorCategory; // Same for the numerator filter
+        };
+
+        vector<Aggregation> aggregations;
+
+        static AnalyticsFilter normalized(AnalyticsFilter filter)
+        {
+            filter.category = FieldDictionary::normalize(filter.category);
+            return filter;
+        }
+
+        // Smallest range of positions holding every row some aggregation can count.
+        DateIndex::Range dateRange(const DateIndex& index) const
+        {
+            int fromKey = INT32_MAX, toKey = INT32_MIN;
+            for (const Aggregation& aggregation : aggregations)
+            {
+                const AnalyticsFilter& filter = aggregation.filter;
+                if (filter.year == 0) return index.all();
+                int from = filter.year * 10000 + filter.month * 100;
+                int to = filter.month == 0 ? filter.year * 10000 + 9999 : from + 99;
+                fromKey = min(fromKey, from);
+                toKey = max(toKey, to);
+            }
+            return index.range(fromKey, toKey);
+        }
+
+        static int category_code(const AnalyticsFilter& filter)
+        {
+            return filter.category.empty() ? -1 : category_dictionary().find(filter.category);
+        }
+
+        // Resolve the category filters to codes; values interned after registration are found too.
+        vector<Accumulator> start() const
+        {
+            vector<Accumulator> accumulators(aggregations.size());
+            size_t categoryCount = category_dictionary().size();
+            for (size_t i = 0; i < aggregations.size(); i++)
+            {
+                accumulators[i].filterCategory = category_code(aggregations[i].filter);
+                accumulators[i].numeratorCategory = category_code(aggregations[i].numerator);
+                if (aggregations[i].groupBy == GROUP_CATEGORY)
+                {
+                    accumulators[i].categories.resize(categoryCount);
+                }
+            }
+            return accumulators;
+        }
+
+        void accumulate(vector<Accumulator>& accumulators, int dateKey, FieldDictionary::Code categoryCode, FieldDictionary::Code labelCode) const
+        {
+            int year = date_year(dateKey);
+            int month = date_month(dateKey);
+            int categoryClass = category_dictionary().classOf(categoryCode);
+            int label = label_dictionary().classOf(labelCode);
+
+            for (size_t i = 0; i < aggregations.size(); i++)
+            {
+                const Aggregation& aggregation = aggregations[i];
+                Accumulator& accumulator = accumulators[i];
+                if (!passes(aggregation.filter, accumulator.filterCategory, year, month, categoryCode, categoryClass, label)) continue;
+                bool matching = !aggregation.ratio ||
+                                passes(aggregation.numerator, accumulator.numeratorCategory, year, month, categoryCode, categoryClass, label);
+
+                AnalyticsCounts* group = nullptr;
+                switch (aggregation.groupBy)
+                {
+                    case GROUP_MONTH:
+                        group = &accumulator.months[(month >= 1 && month <= 12) ? month : 0];
+                        break;
+                    case GROUP_LABEL:
+                        group = &accumulator.labels[label];
+                        break;
+                    case GROUP_CATEGORY:
+                        if (categoryCode >= accumulator.categories.size()) accumulator.categories.resize(categoryCode + 1);
+                        group = &accumulator.categories[categoryCode];
+                        break;
+                    default:
+                        break;
+                }
+
+                accumulator.counts.total++;
+                if (matching) accumulator.counts.matching++;
+                if (group)
+                {
+                    group->total++;
+                    if (matching) group->matching++;
+                }
+            }
+        }
+
+        vector<AnalyticsResult> results(const vector<Accumulator>& accumulators) const
+        {
+            vector<AnalyticsResult> out;
+            out.reserve(aggregations.size());
+            for (size_t i = 0; i < aggregations.size(); i++)
+            {
+                const Accumulator& accumulator = accumulators[i];
+                AnalyticsResult result = { aggregations[i].name, aggregations[i].groupBy, accumulator.counts, {} };
+                switch (aggregations[i].groupBy)
+                {
+                    case GROUP_MONTH:
+                        for (int month = 1; month <= 12; month++)
+                        {
+                            result.groups.push_back({ to_string(month), month, accumulator.months[month] });
+                        }
+                        if (accumulator.months[0].total > 0)
+                        {
+                            result.groups.push_back({ "unknown", 0, accumulator.months[0] });
+                        }
+                        break;
+                    case GROUP_LABEL:
+                        for (ArticleLabel label : { LABEL_FAKE, LABEL_OTHER, LABEL_TRUE })
+                        {
+                            if (accumulator.labels[label].total > 0)
+                            {
+                                result.groups.push_back({ label_name(label), 0, accumulator.labels[label] });
+                            }
+                        }
+                        break;
+                    case GROUP_CATEGORY:
+                        for (size_t code = 0; code < accumulator.categories.size(); code++)
+                        {
+                            if (accumulator.categories[code].total == 0) continue;
+                            result.groups.push_back({ category_dictionary().text(static_cast<FieldDictionary::Code>(code)), 0, accumulator.categories[code] });
+                        }
+                        sort(result.groups.begin(), result.groups.end(),
+                             [](const AnalyticsGroup& a, const AnalyticsGroup& b) { return a.key < b.key; });
+                        break;
+                    default:
+                        break;
+                }
+                out.push_back(move(result));
+            }
+            return out;
+        }
+};
+
+#endif
@@ -1,449 +1,1248 @@
 #include "linkedlist.h"
+#include "unrolledlist.h"
+#include "profiler.h"
+#include "articletable.h"
+#include "csvreader.h"
+#include "wordcounter.h"
+#include "invertedindex.h"
+#include "dateindex.h"
+#include "analytics.h"
+#include "textsearch.h"
+#include "ahocorasick.h"
+#include "tokenizer.h"
+#include "heavyhitters.h"
+#include "csvwriter.h"
+#include "threadpool.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <algorithm>
 #include <cstring>
+#include <climits>
 #include <map>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <filesystem>
 
 #include <chrono> 
-#include <windows.h>      
-#include <psapi.h>
 
 using namespace std;
 using namespace chrono;
 
-struct WordFrequency 
+// Helper function: convert a string to lowercase
+string toLowercase(const string& str) 
+{
+    string result = str;
+    transform(result.begin(), result.end(), result.begin(), ::tolower);
+    return result;
+}
+
+string getMonthAbbreviation(int month) 
 {
-    string word;
-    int frequency;
-    WordFrequency* next;
-    WordFrequency(const string& w, int freq)
-        : word(w), frequency(freq), next(nullptr) {}
+    const string months[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                              "JUL", "AUG", "SEP", "OCT", "NOV", "DEC" };
+    return (month >= 1 && month <= 12) ? months[month - 1] : "UNK";
+}
+
+// Helper function: extract words from content and update the word frequency list. Stop words are dropped and
+// the tokenizer's buffer is reused, so counting a word already seen allocates nothing.
+void extractWords(const string& content, WordCounter& wordCounter, WordTokenizer& tokenizer)
+{
+    tokenizer.forEachWord(content, [&](string_view word) { wordCounter.addWord(word); });
+}
+
+// A row that was left out of the import, with the reason it was rejected.
+struct ImportReject
+{
+    size_t row;    // 1-based data row in the source file (header excluded).
+    string Date;
+    string reason;
 };
 
-class WordFrequencyList {
-private:
-    WordFrequency* head;
-public:
-    WordFrequencyList() : head(nullptr) {}
+// Match a month name ("January") or abbreviation ("Jan"), ignoring case. Returns 1-12, or 0 if unknown.
+int parse_month_name(const char* text, size_t length)
+{
+    static const char* const names[] = { "january", "february", "march", "april", "may", "june",
+                                         "july", "august", "september", "october", "november", "december" };
+    if (length < 3)
+    {
+        return 0;
+    }
+    for (int month = 0; month < 12; month++)
+    {
+        const char* name = names[month];
+        size_t nameLength = strlen(name);
+        if (length != 3 && length != nameLength)
+        {
+            continue;
+        }
+        size_t i = 0;
+        while (i < length && tolower(static_cast<unsigned char>(text[i])) == name[i])
+        {
+            i++;
+        }
+        if (i == length)
+        {
+            return month + 1;
+        }
+    }
+    return 0;
+}
 
-    // Add a word or update its frequency
-    void addWord(const string& word) 
+// Parse a date into a packed yyyymmdd key without going through iostreams or the locale.
+// Accepts "January 15, 2016", "Jan 15, 2016" and "8-Dec-17" (surrounding whitespace is ignored).
+bool parse_date_key(string_view Date, int& key)
+{
+    const char* p = Date.data();
+    const char* end = p + Date.size();
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    auto isAlpha = [](char c) { return (c | 0x20) >= 'a' && (c | 0x20) <= 'z'; };
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+    auto readNumber = [&](int maxDigits, int& value) -> int
     {
-        WordFrequency* current = head;
-        WordFrequency* prev = nullptr;
-        while (current != nullptr) {
-            if (current->word == word) 
-            {
-                current->frequency++;
-                return;
-            }
-            prev = current;
-            current = current->next;
+        int digits = 0;
+        value = 0;
+        while (p < end && isDigit(*p) && digits < maxDigits)
+        {
+            value = value * 10 + (*p - '0');
+            p++;
+            digits++;
         }
-        // If not found, add a new node
-        WordFrequency* newNode = new WordFrequency(word, 1);
-        if (prev == nullptr)
-            head = newNode;
-        else
-            prev->next = newNode;
+        return digits;
+    };
+
+    while (p < end && isSpace(*p)) p++;
+    while (end > p && isSpace(end[-1])) end--;
+
+    int year = 0, month = 0, day = 0;
+    if (p < end && isDigit(*p))
+    {
+        // Format: "8-Dec-17"
+        if (readNumber(2, day) == 0 || p == end || *p++ != '-') return false;
+        const char* monthStart = p;
+        while (p < end && isAlpha(*p)) p++;
+        month = parse_month_name(monthStart, p - monthStart);
+        if (p == end || *p++ != '-') return false;
+        int digits = readNumber(4, year);
+        if (digits == 2) year += 2000;
+        else if (digits != 4) return false;
+    }
+    else
+    {
+        // Format: "January 15, 2016"
+        const char* monthStart = p;
+        while (p < end && isAlpha(*p)) p++;
+        month = parse_month_name(monthStart, p - monthStart);
+        if (p < end && *p == '.') p++;
+        while (p < end && isSpace(*p)) p++;
+        if (readNumber(2, day) == 0) return false;
+        if (p < end && *p == ',') p++;
+        while (p < end && isSpace(*p)) p++;
+        if (readNumber(4, year) != 4) return false;
     }
 
-    // Sort by frequency from highest to lowest (simple bubble sort implementation)
-    void sortByFrequency() 
+    if (p != end || month == 0 || day == 0)
     {
-        if (!head || !head->next) return;
-        bool swapped;
-        do {
-            swapped = false;
-            WordFrequency* current = head;
-            WordFrequency* prev = nullptr;
-            while (current && current->next) 
-            {
-                if (current->frequency < current->next->frequency) 
-                {
-                    WordFrequency* temp = current->next;
-                    current->next = temp->next;
-                    temp->next = current;
-                    if (prev == nullptr)
-                        head = temp;
-                    else
-                        prev->next = temp;
-                    prev = temp;
-                    swapped = true;
-                } 
-                else 
-                {
-                    prev = current;
-                    current = current->next;
-                }
-            }
-        } while (swapped);
+        return false;
+    }
+    static const int daysInMonth[] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > daysInMonth[month - 1] || (month == 2 && day == 29 && !leap))
+    {
+        return false;
     }
+    key = year * 10000 + month * 100 + day;
+    return true;
+}
+
+// Parse the data rows in [begin, end) into list. Row numbers in rejects count from firstRow.
+// Returns the number of rows read, including blank and rejected ones. If unterminatedQuote is given, it is set
+// when the range ended inside a quoted field.
+size_t import_csv_range(const char* begin, const char* end, size_t firstRow, LinkedList<string>& list,
+                        vector<ImportReject>& rejects, bool* unterminatedQuote = nullptr)
+{
+    CsvReader reader(begin, end);
+    vector<string_view> fields;
+    size_t row = firstRow - 1;
 
-    WordFrequency* getHead() {
-        return head;
+    while (reader.next(fields)) 
+    {
+        row++;
+        if (fields.size() == 1 && fields[0].empty())
+        {
+            continue; // Blank line.
+        }
+        fields.resize(FIELD_COUNT);
+
+        int DateKey = 0;
+        if (!parse_date_key(fields[FIELD_DATE], DateKey))
+        {
+            rejects.push_back({ row, string(fields[FIELD_DATE]), "unparseable date" });
+            continue;
+        }
+
+        // Import data into the linked list, building each field straight from the parsed view.
+        list.emplace_back(fields[FIELD_TITLE], fields[FIELD_CONTENT], fields[FIELD_CATEGORY],
+                          fields[FIELD_DATE], fields[FIELD_LABEL], DateKey);
     }
-};
+    if (unterminatedQuote)
+    {
+        *unterminatedQuote = reader.unterminatedQuote();
+    }
+    return row - (firstRow - 1);
+}
 
-// Helper function: convert a string to lowercase
-string toLowercase(const string& str) 
+// Return the position just after the header record.
+const char* skip_csv_header(const char* begin, const char* end)
 {
-    string result = str;
-    transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+    CsvReader reader(begin, end);
+    vector<string_view> header;
+    reader.next(header);
+    return reader.position();
 }
 
-string getMonthAbbreviation(int month) 
+// Parse a year filter typed by the user: "2016" or "16". Returns 0 for an empty filter and -1 for anything
+// else, which matches no article.
+int parse_year_filter(const string& year)
 {
-    const string months[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
-                              "JUL", "AUG", "SEP", "OCT", "NOV", "DEC" };
-    return (month >= 1 && month <= 12) ? months[month - 1] : "UNK";
+    if (year.empty()) return 0;
+    if (year.size() > 4 || !all_of(year.begin(), year.end(), [](char c) { return c >= '0' && c <= '9'; })) return -1;
+    int value = stoi(year);
+    return (year.size() <= 2) ? value + 2000 : value;
+}
+
+// Import CSV file data into a linked list.
+// The file is memory-mapped and split into fields in place; rows whose date cannot be parsed are left out
+// and reported in rejects.
+void import_csv_to_linkedlist(const string& mergefile, LinkedList<string>& list, vector<ImportReject>& rejects)
+{
+    MappedFile merge_file(mergefile);
+    const char* end = merge_file.data() + merge_file.size();
+    import_csv_range(skip_csv_header(merge_file.data(), end), end, 1, list, rejects);
+}
+
+void import_csv_to_linkedlist(const string& mergefile, LinkedList<string>& list)
+{
+    vector<ImportReject> rejects;
+    import_csv_to_linkedlist(mergefile, list, rejects);
 }
 
-// Helper function: extract words from content and update the word frequency list
-void extractWords(const string& content, WordFrequencyList& wordFreqList) {
-    stringstream ss(content);
-    string word;
-    while (ss >> word) 
+// Parallel import: the data rows are split into one byte range per thread, each range is parsed into its own
+// list, and the lists and reject lists are joined in file order, so the result matches the serial import.
+// Range boundaries are moved to the first newline outside a quoted field: quote counts per range give the
+// quote parity at each range start (a doubled "" counts twice, so it never changes the parity).
+void import_csv_to_linkedlist(const string& mergefile, LinkedList<string>& list, vector<ImportReject>& rejects, unsigned threadCount)
+{
+    MappedFile merge_file(mergefile);
+    const char* end = merge_file.data() + merge_file.size();
+    const char* begin = skip_csv_header(merge_file.data(), end);
+    const size_t minBytesPerThread = 1 << 20;
+
+    size_t bytes = end - begin;
+    threadCount = static_cast<unsigned>(min<size_t>(max(threadCount, 1u), bytes / minBytesPerThread + 1));
+    if (threadCount == 1)
     {
-        // Remove punctuation from the beginning of the word
-        while (!word.empty() && ispunct(word.front())) 
+        import_csv_range(begin, end, 1, list, rejects);
+        return;
+    }
+
+    // 1. Count quotes in each equal-sized byte range.
+    vector<const char*> starts(threadCount + 1);
+    for (unsigned i = 0; i <= threadCount; i++)
+    {
+        starts[i] = begin + bytes * i / threadCount;
+    }
+    vector<size_t> quotes(threadCount, 0);
+    vector<thread> workers;
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back([&, i]() { quotes[i] = count(starts[i], starts[i + 1], '"'); });
+    }
+    for (thread& worker : workers) worker.join();
+    workers.clear();
+
+    // 2. Move every range start to the next record boundary.
+    vector<const char*> bounds(threadCount + 1);
+    bounds[0] = begin;
+    bounds[threadCount] = end;
+    bool inQuotes = false;
+    for (unsigned i = 1; i < threadCount; i++)
+    {
+        inQuotes ^= (quotes[i - 1] & 1) != 0;
+        const char* p = starts[i];
+        bool quoted = inQuotes;
+        while (p < end && (quoted || *p != '\n'))
         {
-            word.erase(word.begin());
+            if (*p == '"') quoted = !quoted;
+            p++;
         }
-        // Remove punctuation from the end of the word
-        while (!word.empty() && ispunct(word.back())) 
+        bounds[i] = max(bounds[i - 1], p < end ? p + 1 : end);
+    }
+
+    // 3. Parse the ranges concurrently.
+    vector<LinkedList<string>> parts(threadCount);
+    vector<vector<ImportReject>> partRejects(threadCount);
+    vector<size_t> partRows(threadCount, 0);
+    unique_ptr<bool[]> partUnterminated(new bool[threadCount]());
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back([&, i]()
+        {
+            partRows[i] = import_csv_range(bounds[i], bounds[i + 1], 1, parts[i], partRejects[i], &partUnterminated[i]);
+        });
+    }
+    for (thread& worker : workers) worker.join();
+
+    // A range other than the last one ending inside a quoted field means the quoting is malformed and a
+    // boundary may not match what the serial reader would see: redo the import serially.
+    for (unsigned i = 0; i + 1 < threadCount; i++)
+    {
+        if (partUnterminated[i])
         {
-            word.pop_back();
+            import_csv_range(begin, end, 1, list, rejects);
+            return;
         }
-        if (!word.empty()) 
+    }
+
+    // 4. Join in file order.
+    size_t rowOffset = 0;
+    for (unsigned i = 0; i < threadCount; i++)
+    {
+        for (ImportReject& reject : partRejects[i])
         {
-            word = toLowercase(word);
-            wordFreqList.addWord(word);
+            reject.row += rowOffset;
+            rejects.push_back(move(reject));
         }
+        rowOffset += partRows[i];
+        list.splice_back(parts[i]);
     }
 }
 
-size_t getCurrentMemoryUsage() 
+// One raw source file of the dataset (title,text,subject,date with a header row) and the Label its rows get.
+struct IngestSource
+{
+    string path;
+    string Label;
+};
+
+// True if a field is empty or only whitespace.
+bool is_blank_field(string_view field)
 {
-    #ifdef _WIN32
-    PROCESS_MEMORY_COUNTERS memInfo;
-    GetProcessMemoryInfo(GetCurrentProcess(), &memInfo, sizeof(memInfo));
-    return memInfo.WorkingSetSize;  // Return memory usage in bytes
-    #else
-    struct rusage usage;
-    getrusage(RUSAGE_SELF, &usage);
-    return usage.ru_maxrss * 1024;  // Return bytes
-    #endif
+    return all_of(field.begin(), field.end(), [](char c) { return isspace(static_cast<unsigned char>(c)) != 0; });
 }
 
-// Function to parse a CSV line, taking into account commas within quoted fields.
-void parse_csv(const string& line, string& Title, string& Content, string& Category, string& Date, string& Label)
+// Read the raw source files once each with the quote-aware CsvReader and call onRow(fields, Label, DateKey) for
+// every usable row: rows with a missing or empty field or an unparseable date are dropped and reported in rejects,
+// numbered within their file. The fields are views into the mapped file, valid only during the call. Returns the
+// number of rows passed on. Throws runtime_error if a file cannot be opened.
+template <typename RowSink>
+size_t scan_sources(const vector<IngestSource>& sources, vector<ImportReject>& rejects, RowSink onRow)
 {
-    stringstream ss(line);
-    bool inQuotes = false;
-    char prevChar = '\0';
-    string field;
-    int fieldIndex = 0;
+    size_t accepted = 0;
+    vector<string_view> fields;
+    for (const IngestSource& source : sources)
+    {
+        MappedFile file(source.path);
+        const char* end = file.data() + file.size();
+        CsvReader reader(skip_csv_header(file.data(), end), end);
+        size_t row = 0;
+        while (reader.next(fields))
+        {
+            row++;
+            if (fields.size() == 1 && fields[0].empty())
+            {
+                continue; // Blank line.
+            }
+            if (fields.size() < 4 || any_of(fields.begin(), fields.begin() + 4, is_blank_field))
+            {
+                rejects.push_back({ row, fields.size() >= 4 ? string(fields[3]) : string(), "empty field in " + source.path });
+                continue;
+            }
+
+            int DateKey = 0;
+            if (!parse_date_key(fields[3], DateKey))
+            {
+                rejects.push_back({ row, string(fields[3]), "unparseable date in " + source.path });
+                continue;
+            }
+            onRow(fields, source.Label, DateKey);
+            accepted++;
+        }
+    }
+    return accepted;
+}
+
+// Stream the raw source files straight into list, replacing the remove_empty_row / merge_csv / import chain:
+// each usable row (see scan_sources) gets its source's Label and is appended. Rows are also written to mergefile
+// (the merge.csv layout) when one is given.
+void ingest_sources(const vector<IngestSource>& sources, LinkedList<string>& list, vector<ImportReject>& rejects,
+                    const string& mergefile = "")
+{
+    unique_ptr<CsvWriter> merged;
+    if (!mergefile.empty())
+    {
+        merged.reset(new CsvWriter(mergefile));
+        merged->writeRow({ "Title", "Content", "Category", "Date", "Label" });
+    }
 
-    for (char ch : line)
+    scan_sources(sources, rejects, [&](const vector<string_view>& fields, const string& Label, int DateKey)
     {
-        if(ch == '"' && prevChar != '\\')
+        list.emplace_back(fields[0], fields[1], fields[2], fields[3], Label, DateKey);
+        if (merged)
         {
-            inQuotes = !inQuotes;
+            merged->writeRow({ fields[0], fields[1], fields[2], fields[3], Label });
         }
-        else if (ch == ',' && !inQuotes)
+    });
+    if (merged)
+    {
+        merged->close();
+    }
+}
+
+// Write-only version for the standalone cleaner: the usable rows go straight to mergefile and nothing is kept in
+// memory. Returns the number of rows written.
+size_t write_merged_sources(const vector<IngestSource>& sources, const string& mergefile, vector<ImportReject>& rejects)
+{
+    CsvWriter merged(mergefile);
+    merged.writeRow({ "Title", "Content", "Category", "Date", "Label" });
+    size_t written = scan_sources(sources, rejects, [&](const vector<string_view>& fields, const string& Label, int)
+    {
+        merged.writeRow({ fields[0], fields[1], fields[2], fields[3], Label });
+    });
+    merged.close();
+    return written;
+}
+
+//Function for Save timsort output into csv file
+// Rows are escaped per RFC 4180 (Date, Title and Content often contain commas or quotes) and written through a
+// large buffer. With threadCount > 1 the list is cut into chunks that are formatted on a thread pool, one wave
+// at a time, while the previous wave is being written; chunks are written in list order.
+void save_sorted_data_to_csv(LinkedList<string>& newsList, const string& filename, unsigned threadCount = 1) 
+{
+    const size_t chunkRows = 4096;
+    try
+    {
+        CsvWriter writer(filename);
+        writer.writeRow({ "Date", "Title", "Content", "Category", "Label" }); // Writing headers
+
+        auto formatChunk = [](Article<string>* current, size_t rows, string& out)
         {
-            switch (fieldIndex)
+            out.clear();
+            for (size_t i = 0; i < rows && current; i++, current = current->next)
             {
-                case 0: Title = field;
-                    break;
-                case 1: Content = field;
-                    break;
-                case 2: Category = field;
-                    break;
-                case 3: Date = field;
-                    break;
-                case 4: Label = field;
+                append_csv_row(out, { current->Date, current->Title, current->Content, current->Category, current->Label });
+            }
+        };
+
+        if (threadCount <= 1)
+        {
+            for (Article<string>* current = newsList.getHead(); current; current = current->next)
+            {
+                writer.writeRow({ current->Date, current->Title, current->Content, current->Category, current->Label });
+            }
+        }
+        else
+        {
+            // First node of every chunk.
+            vector<Article<string>*> chunks;
+            size_t index = 0;
+            for (Article<string>* current = newsList.getHead(); current; current = current->next, index++)
+            {
+                if (index % chunkRows == 0) chunks.push_back(current);
+            }
+
+            ThreadPool pool(threadCount);
+            size_t waveSize = static_cast<size_t>(threadCount) * 2;
+            vector<string> formatted(chunks.size() < waveSize ? chunks.size() : waveSize), next(formatted.size());
+            auto formatWave = [&](size_t first, vector<string>& out, TaskGroup& group)
+            {
+                for (size_t c = first; c < chunks.size() && c < first + waveSize; c++)
+                {
+                    string* target = &out[c - first];
+                    Article<string>* start = chunks[c];
+                    group.run([=, &formatChunk]() { formatChunk(start, chunkRows, *target); });
+                }
+            };
+
+            {
+                TaskGroup group(pool);
+                formatWave(0, formatted, group);
+                group.wait();
+            }
+            for (size_t first = 0; first < chunks.size(); first += waveSize)
+            {
+                TaskGroup group(pool);
+                formatWave(first + waveSize, next, group);
+                for (size_t c = first; c < chunks.size() && c < first + waveSize; c++)
+                {
+                    writer.writeFormatted(formatted[c - first]);
+                }
+                group.wait();
+                formatted.swap(next);
+            }
+        }
+        writer.close();
+    }
+    catch (const runtime_error& e)
+    {
+        cerr << "Error: " << e.what() << endl;
+        return;
+    }
+    cout << "Sorted data saved to " << filename << endl;
+}
+
+// Sorting algorithm: Use TimSort to sort the linked list by date (ascending).
+// Natural runs (non-decreasing, or strictly decreasing and then reversed) are detected and extended to
+// minrun by insertion, kept on a growable run stack and merged with galloping, so date-ordered input sorts in O(n).
+class TimSort {
+    public:
+        bool is_less_than(const Article<string>* a, const Article<string>* b) {
+            PROFILE_COUNT(COUNTER_DATE_COMPARISONS);
+            return a->DateKey < b->DateKey;
+        }
+
+        // Sort a detached chain of nodes; head is updated to the first node after sorting.
+        void timSort(Article<string>*& head) 
+        {
+            size_t n = 0;
+            for (Article<string>* node = head; node; node = node->next) n++;
+            head = sort_chain(head, n).head;
+        }
+
+        // Sort the list in place and keep its tail pointer in step with the new order.
+        void timSort(LinkedList<string>& list)
+        {
+            Run sorted = sort_chain(list.getHead(), list.getSize());
+            list.setHead(sorted.head);
+            list.setTail(sorted.tail);
+        }
+
+    private:
+        static const size_t MIN_MERGE = 64;
+        static const size_t MIN_GALLOP = 7;
+
+        // A sorted, nullptr-terminated chain of nodes.
+        struct Run
+        {
+            Article<string>* head;
+            Article<string>* tail;
+            size_t length;
+        };
+
+        vector<Run> runs;
+        size_t minGallop = MIN_GALLOP;
+
+        Run sort_chain(Article<string>* head, size_t n)
+        {
+            if (!head || !head->next) return { head, head, n };
+
+            runs.clear();
+            minGallop = MIN_GALLOP;
+            size_t minRun = min_run_length(n);
+            Article<string>* current = head;
+            while (current)
+            {
+                runs.push_back(next_run(current, minRun));
+                merge_collapse();
+            }
+            merge_force_collapse();
+            return runs[0];
+        }
+
+        // Same minrun rule as CPython/Java: a value in [32, 64] such that n / minrun is close to a power of two.
+        static size_t min_run_length(size_t n)
+        {
+            size_t r = 0;
+            while (n >= MIN_MERGE)
+            {
+                r |= n & 1;
+                n >>= 1;
+            }
+            return n + r;
+        }
+
+        // Detach the next natural run starting at current and extend it to minRun nodes by insertion.
+        // current is advanced to the first node after the run.
+        Run next_run(Article<string>*& current, size_t minRun)
+        {
+            Run run = { current, current, 1 };
+            Article<string>* node = current->next;
+
+            if (node && is_less_than(node, run.head))
+            {
+                // Strictly descending: reverse while detaching, which keeps the sort stable.
+                run.tail->next = nullptr;
+                while (node && is_less_than(node, run.head))
+                {
+                    Article<string>* next = node->next;
+                    node->next = run.head;
+                    run.head = node;
+                    run.length++;
+                    node = next;
+                }
+            }
+            else
+            {
+                while (node && !is_less_than(node, run.tail))
+                {
+                    run.tail = node;
+                    run.length++;
+                    node = node->next;
+                }
+                run.tail->next = nullptr;
+            }
+
+            // Short run: pull in following nodes one at a time, after any equal dates.
+            while (node && run.length < minRun)
+            {
+                Article<string>* next = node->next;
+                if (!is_less_than(node, run.tail))
+                {
+                    run.tail->next = node;
+                    run.tail = node;
+                    node->next = nullptr;
+                }
+                else if (is_less_than(node, run.head))
+                {
+                    node->next = run.head;
+                    run.head = node;
+                }
+                else
+                {
+                    Article<string>* prev = run.head;
+                    while (!is_less_than(node, prev->next)) prev = prev->next;
+                    node->next = prev->next;
+                    prev->next = node;
+                }
+                run.length++;
+                node = next;
+            }
+
+            current = node;
+            return run;
+        }
+
+        // Keep the run stack invariants: len[i-2] > len[i-1] + len[i] and len[i-1] > len[i].
+        void merge_collapse()
+        {
+            while (runs.size() > 1)
+            {
+                size_t n = runs.size() - 2;
+                if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length) ||
+                    (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length))
+                {
+                    if (runs[n - 1].length < runs[n + 1].length) n--;
+                }
+                else if (runs[n].length > runs[n + 1].length)
+                {
                     break;
-                default: break;
+                }
+                merge_at(n);
+            }
+        }
+
+        void merge_force_collapse()
+        {
+            while (runs.size() > 1)
+            {
+                size_t n = runs.size() - 2;
+                if (n > 0 && runs[n - 1].length < runs[n + 1].length) n--;
+                merge_at(n);
+            }
+        }
+
+        void merge_at(size_t i)
+        {
+            runs[i] = merge(runs[i], runs[i + 1]);
+            runs.erase(runs.begin() + i + 1);
+        }
+
+        // Count the leading nodes from node for which pred holds (pred must be true then false along the chain).
+        // Probes at exponentially growing offsets and then narrows down, so k nodes cost O(log k) comparisons.
+        // last is set to the last node counted.
+        template <typename Pred>
+        size_t gallop(Article<string>* node, Pred pred, Article<string>*& last)
+        {
+            last = nullptr;
+            if (!pred(node)) return 0;
+
+            Article<string>* good = node;
+            size_t count = 1;
+            size_t step = 1;
+            while (true)
+            {
+                Article<string>* probe = good;
+                size_t advanced = 0;
+                while (advanced < step && probe->next)
+                {
+                    probe = probe->next;
+                    advanced++;
+                }
+                if (advanced == 0) break;
+
+                if (pred(probe))
+                {
+                    good = probe;
+                    count += advanced;
+                    if (advanced < step) break;
+                    step *= 2;
+                    continue;
+                }
+
+                // The boundary lies among the advanced - 1 nodes between good and probe.
+                size_t unknown = advanced - 1;
+                while (unknown > 0)
+                {
+                    size_t half = (unknown + 1) / 2;
+                    Article<string>* candidate = good;
+                    for (size_t i = 0; i < half; i++) candidate = candidate->next;
+                    if (pred(candidate))
+                    {
+                        good = candidate;
+                        count += half;
+                        unknown -= half;
+                    }
+                    else
+                    {
+                        unknown = half - 1;
+                    }
+                }
+                break;
+            }
+            last = good;
+            return count;
+        }
+
+        // Merge two adjacent runs (a before b). Equal dates keep a's nodes first.
+        Run merge(Run a, Run b)
+        {
+            Run merged = { a.head, b.tail, a.length + b.length };
+
+            // Already in order: O(1) splice, which is what makes date-ordered input linear.
+            if (!is_less_than(b.head, a.tail))
+            {
+                a.tail->next = b.head;
+                return merged;
+            }
+
+            Article<string> dummy;
+            Article<string>* tail = &dummy;
+            Article<string>* left = a.head;
+            Article<string>* right = b.head;
+            Article<string>* last = nullptr;
+
+            auto takeLeft = [&](Article<string>* until) { tail->next = left; tail = until; left = until->next; };
+            auto takeRight = [&](Article<string>* until) { tail->next = right; tail = until; right = until->next; };
+
+            // Nodes of a that are not after b's first node are already in place.
+            if (gallop(left, [&](Article<string>* x) { return !is_less_than(right, x); }, last) > 0)
+            {
+                takeLeft(last);
+            }
+
+            while (left && right)
+            {
+                // One pair at a time until one side keeps winning.
+                size_t leftWins = 0, rightWins = 0;
+                while (left && right && leftWins < minGallop && rightWins < minGallop)
+                {
+                    if (is_less_than(right, left))
+                    {
+                        takeRight(right);
+                        rightWins++;
+                        leftWins = 0;
+                    }
+                    else
+                    {
+                        takeLeft(left);
+                        leftWins++;
+                        rightWins = 0;
+                    }
+                }
+
+                // Galloping mode: move whole blocks while they stay long.
+                size_t leftCount = MIN_GALLOP, rightCount = MIN_GALLOP;
+                while (left && right && (leftCount >= MIN_GALLOP || rightCount >= MIN_GALLOP))
+                {
+                    if (minGallop > 1) minGallop--;
+                    leftCount = gallop(left, [&](Article<string>* x) { return !is_less_than(right, x); }, last);
+                    if (leftCount > 0) takeLeft(last);
+                    if (!left) break;
+                    takeRight(right);
+                    if (!right) break;
+
+                    rightCount = gallop(right, [&](Article<string>* x) { return is_less_than(x, left); }, last);
+                    if (rightCount > 0) takeRight(last);
+                    if (!right) break;
+                    takeLeft(left);
+                }
+                minGallop += 2;
+            }
+
+            if (left)
+            {
+                tail->next = left;
+                merged.tail = a.tail;
+            }
+            else
+            {
+                tail->next = right;
+            }
+            merged.head = dummy.next;
+            return merged;
+        }
+    };
+
+// Radix sort by date: a stable O(n + buckets) alternative to TimSort with the same result. Nodes are appended
+// to one chain per bucket in list order and the chains are concatenated, so no node is moved or allocated; only
+// the bucket head/tail arrays are (and they are kept between calls).
+// When every key is a valid calendar date, days are numbered densely (372 slots a year), so a few years of
+// articles fit in one counting pass over about a thousand buckets. Otherwise, or when the span is too wide,
+// the keys are sorted by LSD passes over 16-bit digits.
+class RadixSort
+{
+    public:
+        // Sort the list in place and keep its tail pointer in step with the new order.
+        void radixSort(LinkedList<string>& list)
+        {
+            Article<string>* head = list.getHead();
+            Article<string>* tail = sort_chain(head, list.getSize());
+            list.setHead(head);
+            list.setTail(tail);
+        }
+
+        // Sort a detached chain of nodes; head is updated to the first node after sorting.
+        void radixSort(Article<string>*& head)
+        {
+            size_t n = 0;
+            for (Article<string>* node = head; node; node = node->next) n++;
+            sort_chain(head, n);
+        }
+
+    private:
+        static const unsigned DIGIT_BITS = 16;
+
+        vector<Article<string>*> bucketHeads;
+        vector<Article<string>*> bucketTails;
+
+        static bool is_calendar_key(int key)
+        {
+            int month = date_month(key), day = date_day(key);
+            return key > 0 && month >= 1 && month <= 12 && day >= 1 && day <= 31;
+        }
+
+        // Order-preserving dense day number of a valid calendar key.
+        static uint32_t day_number(int key)
+        {
+            return static_cast<uint32_t>(date_year(key) * 372 + (date_month(key) - 1) * 31 + (date_day(key) - 1));
+        }
+
+        // Returns the new tail.
+        Article<string>* sort_chain(Article<string>*& head, size_t n)
+        {
+            if (!head || !head->next) return head;
+
+            bool calendar = true;
+            int minKey = head->DateKey, maxKey = head->DateKey;
+            for (Article<string>* node = head; node; node = node->next)
+            {
+                minKey = min(minKey, node->DateKey);
+                maxKey = max(maxKey, node->DateKey);
+                calendar = calendar && is_calendar_key(node->DateKey);
+            }
+            if (minKey == maxKey)
+            {
+                Article<string>* tail = head;
+                while (tail->next) tail = tail->next;
+                return tail;
+            }
+
+            if (calendar)
+            {
+                uint32_t base = day_number(minKey);
+                size_t span = day_number(maxKey) - base + 1;
+                if (span <= max<size_t>(n, size_t(1) << DIGIT_BITS))
+                {
+                    return distribute(head, span, [base](const Article<string>* node) { return day_number(node->DateKey) - base; });
+                }
+            }
+
+            // LSD passes over the key's offset from the minimum, low digit first; each pass is stable.
+            uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(maxKey) - minKey);
+            const uint32_t mask = (1u << DIGIT_BITS) - 1;
+            Article<string>* tail = nullptr;
+            for (unsigned shift = 0; shift < 32 && (range >> shift) != 0; shift += DIGIT_BITS)
+            {
+                tail = distribute(head, size_t(1) << DIGIT_BITS, [minKey, shift, mask](const Article<string>* node)
+                {
+                    return (static_cast<uint32_t>(static_cast<int64_t>(node->DateKey) - minKey) >> shift) & mask;
+                });
+            }
+            return tail;
+        }
+
+        // One stable bucket pass: append every node to the chain of bucketOf(node), then join the chains in
+        // bucket order. Returns the new tail.
+        template <typename BucketOf>
+        Article<string>* distribute(Article<string>*& head, size_t buckets, BucketOf bucketOf)
+        {
+            bucketHeads.assign(buckets, nullptr);
+            bucketTails.resize(buckets);
+            for (Article<string>* node = head; node; node = node->next)
+            {
+                size_t b = bucketOf(node);
+                if (bucketHeads[b])
+                {
+                    bucketTails[b]->next = node;
+                }
+                else
+                {
+                    bucketHeads[b] = node;
+                }
+                bucketTails[b] = node;
+            }
+
+            Article<string>* tail = nullptr;
+            for (size_t b = 0; b < buckets; b++)
+            {
+                if (!bucketHeads[b]) continue;
+                if (tail)
+                {
+                    tail->next = bucketHeads[b];
+                }
+                else
+                {
+                    head = bucketHeads[b];
+                }
+                tail = bucketTails[b];
+            }
+            tail->next = nullptr;
+            return tail;
+        }
+};
+
+// Parallel sort: the same stable date order as TimSort, using a thread pool. The nodes' (DateKey, pointer) pairs
+// are copied into an array, equal-sized segments are stable-sorted as pool tasks, and adjacent segments are
+// merged pairwise, round by round. Each merge is cut into pieces along its merge path (the split of the output
+// at a given position between the two inputs, found by binary search), so every round keeps all threads busy
+// even when only one pair is left. Finally the nodes are relinked in sorted order.
+class ParallelMergeSort
+{
+    public:
+        // Lists shorter than this are handed to TimSort; splitting them costs more than it saves.
+        static const size_t SERIAL_CUTOFF = 1 << 14;
+
+        void sort(LinkedList<string>& list, ThreadPool& pool)
+        {
+            size_t n = list.getSize();
+            if (n < SERIAL_CUTOFF || pool.size() < 2)
+            {
+                TimSort serial;
+                serial.timSort(list);
+                return;
+            }
+
+            vector<SortItem> items(n), buffer(n);
+            size_t i = 0;
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                items[i++] = { node->DateKey, node };
+            }
+
+            // A few segments per thread, so stealing can even out uneven segments.
+            size_t segmentCount = min<size_t>(pool.size() * 4, n / 1024);
+            vector<size_t> bounds(segmentCount + 1);
+            for (size_t s = 0; s <= segmentCount; s++) bounds[s] = n * s / segmentCount;
+
+            parallel_for_ranges(pool, segmentCount, segmentCount, [&](size_t first, size_t last)
+            {
+                for (size_t s = first; s < last; s++)
+                {
+                    stable_sort(items.begin() + bounds[s], items.begin() + bounds[s + 1], item_less);
+                }
+            });
+
+            while (bounds.size() > 2)
+            {
+                merge_round(pool, items, buffer, bounds);
+                items.swap(buffer);
+            }
+
+            parallel_for_ranges(pool, n - 1, pool.size() * 4, [&](size_t first, size_t last)
+            {
+                for (size_t k = first; k < last; k++) items[k].node->next = items[k + 1].node;
+            });
+            items[n - 1].node->next = nullptr;
+            list.setHead(items[0].node);
+            list.setTail(items[n - 1].node);
+        }
+
+        void sort(LinkedList<string>& list, unsigned threadCount)
+        {
+            ThreadPool pool(threadCount);
+            sort(list, pool);
+        }
+
+    private:
+        struct SortItem
+        {
+            int key;
+            Article<string>* node;
+        };
+
+        static bool item_less(const SortItem& a, const SortItem& b)
+        {
+            PROFILE_COUNT(COUNTER_DATE_COMPARISONS);
+            return a.key < b.key;
+        }
+
+        // Merge segments 0+1, 2+3, ... from source into target (an odd last segment is copied) and halve bounds.
+        static void merge_round(ThreadPool& pool, const vector<SortItem>& source, vector<SortItem>& target, vector<size_t>& bounds)
+        {
+            size_t n = source.size();
+            size_t pieceSize = max<size_t>(n / (pool.size() * 4), 4096);
+            vector<size_t> merged;
+            TaskGroup group(pool);
+            for (size_t s = 0; s + 1 < bounds.size(); s += 2)
+            {
+                size_t begin = bounds[s];
+                size_t middle = bounds[s + 1];
+                size_t end = (s + 2 < bounds.size()) ? bounds[s + 2] : middle;
+                merged.push_back(begin);
+
+                const SortItem* a = source.data() + begin;
+                const SortItem* b = source.data() + middle;
+                size_t aLength = middle - begin, bLength = end - middle;
+                SortItem* out = target.data() + begin;
+                for (size_t d = 0; d < aLength + bLength; d += pieceSize)
+                {
+                    size_t dEnd = min(d + pieceSize, aLength + bLength);
+                    group.run([=]()
+                    {
+                        size_t aFirst = merge_path(a, aLength, b, bLength, d);
+                        size_t aLast = merge_path(a, aLength, b, bLength, dEnd);
+                        merge(a + aFirst, a + aLast, b + (d - aFirst), b + (dEnd - aLast), out + d, item_less);
+                    });
+                }
             }
-            field.clear();
-            fieldIndex++;
+            merged.push_back(n);
+            group.wait();
+            bounds.swap(merged);
         }
-        else
+
+        // Number of items taken from a among the first d outputs of a stable merge of a and b
+        // (ties go to a, as in std::merge).
+        static size_t merge_path(const SortItem* a, size_t aLength, const SortItem* b, size_t bLength, size_t d)
         {
-            field += ch;
+            size_t low = (d > bLength) ? d - bLength : 0;
+            size_t high = min(d, aLength);
+            while (low < high)
+            {
+                size_t mid = low + (high - low) / 2;
+                // a[mid] is among the first d outputs unless b[d - mid - 1] sorts strictly before it.
+                if (!item_less(b[d - mid - 1], a[mid]))
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            return low;
         }
-        prevChar = ch;
-    }
-
-    if(fieldIndex == 4)
-    {
-        Label = field;
-    }
-}
+};
 
-// Import CSV file data into a linked list.
-void import_csv_to_linkedlist(const string& mergefile, LinkedList<string>& list) 
+// Size and modification time of a file, which identify the CSV a snapshot was built from. Returns false if the
+// file cannot be read.
+bool source_stamp(const string& path, uint64_t& bytes, int64_t& modified)
 {
-    ifstream merge_file(mergefile);
-    if (!merge_file.is_open()) 
-    {
-        throw runtime_error("Failed to open the file for import.");
-    }
-
-    string line;
-
-    // Skip header (do not import header)
-    getline(merge_file, line);
-
-    while (getline(merge_file, line)) 
-    {
-        string Title, Content, Category, Date, Label;
-        parse_csv(line, Title, Content, Category, Date, Label);
-
-        // Import data into the linked list.
-        list.pushback(Title, Content, Category, Date, Label); 
-    }
-    merge_file.close();
+    error_code error;
+    uintmax_t size = filesystem::file_size(path, error);
+    if (error) return false;
+    filesystem::file_time_type time = filesystem::last_write_time(path, error);
+    if (error) return false;
+    bytes = size;
+    modified = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
 }
 
-// Get the complete date data.
-tm extract_date(string Date)
+// Start from the sorted table in snapshotPath when it was built from the current csvPath; otherwise import and
+// sort csvPath, build the table and write a new snapshot for the next start. If csvPath is missing, any readable
+// snapshot is used. Returns true when the snapshot was loaded, false when it was rebuilt.
+bool load_or_build_snapshot(const string& csvPath, const string& snapshotPath, ArticleTable& table, unsigned threadCount = 1)
 {
-    tm tm = {};
-    istringstream ss;
-
-    // Check for comma to determine format
-    if (Date.find(',') != string::npos) 
-    {
-        // Format: "January 15, 2016"
-        ss.str(Date);
-        ss >> get_time(&tm, "%B %d, %Y");
-    } 
-    else 
+    uint64_t sourceBytes = 0;
+    int64_t sourceModified = 0;
+    bool haveSource = source_stamp(csvPath, sourceBytes, sourceModified);
+    try
     {
-        // Ensure day is two digits for formats like "8-Dec-17"
-        if (Date[1] == '-') // If the second character is '-', it's a single-digit day
+        ArticleTable loaded = ArticleTable::loadSnapshot(snapshotPath);
+        if (!haveSource || (loaded.snapshotSourceBytes() == sourceBytes && loaded.snapshotSourceModified() == sourceModified))
         {
-            Date.insert(0, "0"); // Prepend '0' to make it two digits
+            table = move(loaded);
+            return true;
         }
-
-        // Format: "08-Dec-17"
-        ss.str(Date);
-        ss >> get_time(&tm, "%d-%b-%y");
     }
-
-    if (ss.fail()) 
+    catch (const runtime_error&)
     {
-        throw runtime_error("Failed to parse date: " + Date);
+        if (!haveSource) throw;
     }
 
-    return tm;
+    LinkedList<string> list;
+    vector<ImportReject> rejects;
+    import_csv_to_linkedlist(csvPath, list, rejects, threadCount);
+    RadixSort sorter;
+    sorter.radixSort(list);
+    table = ArticleTable::fromList(list);
+    table.saveSnapshot(snapshotPath, sourceBytes, sourceModified);
+    return false;
 }
 
-// Compare two dates.
-bool compare_date(const string& date1, const string& date2)
+// Result of a batch keyword search for one keyword.
+struct KeywordHits
 {
-    tm tm1 = extract_date(date1);
-    tm tm2 = extract_date(date2);
+    string keyword;
+    vector<Article<string>*> articles; // Every matching article, in list order
+    size_t occurrences = 0;            // Matches summed over those articles
+};
 
-    // First, compare the year.
-    if (tm1.tm_year != tm2.tm_year)
+// Incremental ingest of a new batch (e.g. one day of articles) into the date-sorted list: only the batch file is
+// imported and sorted, it is merged into the list, and the date index and keyword index, when given, are updated
+// instead of rebuilt. With a date index the merge starts at the batch's earliest date, so a batch of recent
+// articles costs about its own size; without one it is a single pass over the list. New articles get the next
+// keyword index row ids, so indexed search lists them after the older articles. Skipped rows are added to rejects
+// with the batch file named in the reason. Returns the number of rows added.
+size_t append_batch(const string& batchfile, LinkedList<string>& list, vector<ImportReject>& rejects,
+                    DateIndex* dateIndex = nullptr, InvertedIndex* keywordIndex = nullptr, unsigned threadCount = 1)
+{
+    LinkedList<string> batch;
+    size_t firstReject = rejects.size();
+    import_csv_to_linkedlist(batchfile, batch, rejects, threadCount);
+    for (size_t i = firstReject; i < rejects.size(); i++)
     {
-        return tm1.tm_year < tm2.tm_year;
+        rejects[i].reason += " in " + batchfile;
     }
-
-    // Second, compare the month.
-    if (tm1.tm_mon != tm2.tm_mon)
+    if (batch.getSize() == 0)
     {
-        return tm1.tm_mon < tm2.tm_mon;
+        return 0;
     }
+    RadixSort sorter;
+    sorter.radixSort(batch);
 
-    // Lastly, compare the day.
-    return tm1.tm_mday < tm2.tm_mday;
-}
+    vector<Article<string>*> added;
+    added.reserve(batch.getSize());
+    for (Article<string>* node = batch.getHead(); node; node = node->next)
+    {
+        added.push_back(node);
+    }
 
-// Sorting algorithm: Use TimSort to sort the linked list by date (ascending).
-class TimSort {
-    public:
-        bool is_less_than(const string& a, const string& b) {
-            return compare_date(a, b);
-        }
-    
-        void insertion_sort(Article<string>*& head) {
-            if (!head || !head->next) return;
-    
-            Article<string>* sorted = nullptr;
-            Article<string>* current = head;
-    
-            while (current) {
-                Article<string>* next = current->next;
-    
-                if (!sorted || is_less_than(current->Date, sorted->Date)) {
-                    current->next = sorted;
-                    sorted = current;
-                } else {
-                    Article<string>* temp = sorted;
-                    while (temp->next && is_less_than(temp->next->Date, current->Date)) {
-                        temp = temp->next;
-                    }
-                    current->next = temp->next;
-                    temp->next = current;
-                }
-                current = next;
-            }
-            head = sorted;
-        }
-    
-        // Merge two sorted linked lists.
-        Article<string>* merge(Article<string>* left, Article<string>* right) {
-            Article<string> dummy;
-            Article<string>* tail = &dummy;
-    
-            while (left && right) {
-                if (is_less_than(left->Date, right->Date)) 
-                {
-                    tail->next = left;
-                    left = left->next;
-                } 
-                else 
-                {
-                    tail->next = right;
-                    right = right->next;
-                }
-                tail = tail->next;
-            }
-    
-            if (left) tail->next = left;
-            if (right) tail->next = right;
-    
-            return dummy.next;
+    Article<string>* start = nullptr;
+    if (dateIndex != nullptr)
+    {
+        DateIndex::Range before = dateIndex->range(INT_MIN, added.front()->DateKey);
+        if (before.end > 0)
+        {
+            start = dateIndex->article(before.end - 1);
         }
-    
-        void timSort(Article<string>*& head) 
+        dateIndex->insertSorted(added);
+    }
+    list.merge_sorted(batch, start);
+
+    if (keywordIndex != nullptr)
+    {
+        for (Article<string>* node : added)
         {
-            if (!head || !head->next) return;
-    
-            const int RUN = 32;
-            const int MAX_RUN = 1500;
-            Article<string>* run[MAX_RUN];
-            int runCount = 0;
-    
-            Article<string>* current = head;
-    
-            while (current) {
-                Article<string>* runHead = current;
-                Article<string>* runTail = current;
-                int count = 1;
-    
-                while (runTail->next && count < RUN) 
-                {
-                    runTail = runTail->next;
-                    count++;
-                }
-    
-                Article<string>* nextRUN = runTail->next;
-                runTail->next = nullptr;
-    
-                insertion_sort(runHead);
-                run[runCount++] = runHead;
-    
-                current = nextRUN;
-            }
-    
-            // Merge sorted runs
-            while (runCount > 1) {
-                int newRunCount = 0;
-                for (int i = 0; i < runCount; i += 2) 
-                {
-                    if (i + 1 < runCount)
-                        run[newRunCount++] = merge(run[i], run[i + 1]);
-                    else
-                        run[newRunCount++] = run[i];
-                }
-                runCount = newRunCount;
-            }
-            head = run[0];  // Update the linked list head
+            keywordIndex->add(node);
         }
-    };
+    }
+    return added.size();
+}
 
 // Searching algorithm: Linear search
+// The list queries take any list with getHead() and chained next pointers: LinkedList<string> or UnrolledList<string>.
 class LinearSearch 
 {
     public:
         //--------------- 1. Count the total number of news articles (both fake and true)--------------------
-        void countNews(LinkedList<string>& list) 
+        template <typename List>
+        void countNews(const List& list)
+        {
+            int trueCount = 0, fakeCount = 0;
+            countLabels(list, trueCount, fakeCount);
+            printNewsCounts(trueCount, fakeCount);
+        }
+
+        void countNews(const ArticleTable& table)
         {
             int trueCount = 0, fakeCount = 0;
+            countLabels(table, trueCount, fakeCount);
+            printNewsCounts(trueCount, fakeCount);
+        }
+
+        // Count true and fake labels (case- and whitespace-insensitive) without printing.
+        template <typename List>
+        void countLabels(const List& list, int& trueCount, int& fakeCount)
+        {
+            const FieldDictionary& labels = label_dictionary();
             Article<string>* current = list.getHead();
             while (current != nullptr) 
             {
-                // Convert Label to lowercase for comparison
-                string label = current->Label;
-                transform(label.begin(), label.end(), label.begin(), ::tolower);
-                if (label == "true")
+                // Label was classified once, when it was interned at import.
+                int label = labels.classOf(current->LabelCode);
+                if (label == LABEL_TRUE)
                     trueCount++;
-                else if (label == "fake")
+                else if (label == LABEL_FAKE)
                     fakeCount++;
                 current = current->next;
             }
+        }
+
+        // Columnar version: only the label code column is read.
+        void countLabels(const ArticleTable& table, int& trueCount, int& fakeCount)
+        {
+            const FieldDictionary& labels = label_dictionary();
+            for (ArticleTable::RowId row = 0; row < table.getSize(); row++)
+            {
+                int label = labels.classOf(table.labelCode(row));
+                if (label == LABEL_TRUE)
+                    trueCount++;
+                else if (label == LABEL_FAKE)
+                    fakeCount++;
+            }
+        }
+
+        void printNewsCounts(int trueCount, int fakeCount)
+        {
             cout << string(15,'-') << "Total News" << string(15,'-') << endl;
             cout << "Total true news: " << trueCount << endl;
             cout << "Total fake news: " << fakeCount << endl;
         }
     
         //.----------- 2. Calculate the percentage of fake news in political news for 2016.-------------------
-        double percentageFakePolitical2016(LinkedList<string>& list) 
+        template <typename List>
+        double percentageFakePolitical2016(const List& list)
         {
-            // Trim leading and trailing whitespace.
-            auto trim = [](const string &s) -> string 
-            {
-                size_t start = s.find_first_not_of(" \t\n\r");
-                if (start == string::npos) return "";
-                size_t end = s.find_last_not_of(" \t\n\r");
-                return s.substr(start, end - start + 1);
-            };
-        
-            // Remove all spaces from the string.
-            auto removeSpaces = [](const string &s) -> string 
-            {
-                string res;
-                for (char c : s) 
-                {
-                    if (!isspace(c)) 
-                    {
-                        res.push_back(c);
-                    }
-                }
-                return res;
-            };
-        
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
             int totalPolitical2016 = 0;
             int fakePolitical2016 = 0;
             Article<string>* current = list.getHead();
             while (current != nullptr) 
             {
-                // Process date: assume format "DD-MM-YY", check if year is "16"
-                string dateStr = trim(current->Date);
-                if (dateStr.size() >= 8 && dateStr.substr(6, 2) == "16") 
+                if (date_year(current->DateKey) == 2016) 
                 {
-                    // Normalize category: remove spaces and convert to lowercase
-                    string categoryNormalized = toLowercase(removeSpaces(current->Category));
-                    // Consider both "politics" and "politicsNews" as political news.
-                    if (categoryNormalized == "politics" || categoryNormalized == "politicsnews") 
+                    // "politics" and "politicsNews" (any case or spacing) share the political class.
+                    if (categories.classOf(current->CategoryCode) == CATEGORY_POLITICAL) 
                     {
                         totalPolitical2016++;
-                        // Normalize label: remove spaces and convert to lowercase.
-                        string labelNormalized = toLowercase(removeSpaces(current->Label));
-                        if (labelNormalized == "fake")
+                        if (labels.classOf(current->LabelCode) == LABEL_FAKE)
                             fakePolitical2016++;
                     }
                 }
@@ -453,73 +1252,172 @@ class LinearSearch
                 return 0.0;
             return (static_cast<double>(fakePolitical2016) / totalPolitical2016) * 100;
         }        
+
+        // Columnar version: reads the date key column first and only touches the code columns for 2016 rows.
+        double percentageFakePolitical2016(const ArticleTable& table)
+        {
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
+            int totalPolitical2016 = 0;
+            int fakePolitical2016 = 0;
+            for (ArticleTable::RowId row = 0; row < table.getSize(); row++)
+            {
+                if (date_year(table.dateKey(row)) != 2016) continue;
+                if (categories.classOf(table.categoryCode(row)) == CATEGORY_POLITICAL)
+                {
+                    totalPolitical2016++;
+                    if (labels.classOf(table.labelCode(row)) == LABEL_FAKE)
+                        fakePolitical2016++;
+                }
+            }
+            if (totalPolitical2016 == 0)
+                return 0.0;
+            return (static_cast<double>(fakePolitical2016) / totalPolitical2016) * 100;
+        }
+
+        // Date index version: only the 2016 rows are visited (two binary searches find them).
+        double percentageFakePolitical2016(const DateIndex& index)
+        {
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
+            int totalPolitical2016 = 0;
+            int fakePolitical2016 = 0;
+            DateIndex::Range year = index.yearRange(2016);
+            for (size_t position = year.begin; position < year.end; position++)
+            {
+                const Article<string>* article = index.article(position);
+                if (categories.classOf(article->CategoryCode) == CATEGORY_POLITICAL)
+                {
+                    totalPolitical2016++;
+                    if (labels.classOf(article->LabelCode) == LABEL_FAKE)
+                        fakePolitical2016++;
+                }
+            }
+            if (totalPolitical2016 == 0)
+                return 0.0;
+            return (static_cast<double>(fakePolitical2016) / totalPolitical2016) * 100;
+        }
         
         //.----- 3. In fake government news, count the most frequent words in the content and output the top 10..------
-        void top10FrequentWordsInGovernmentFakeNews(LinkedList<string>& list) 
+        template <typename List>
+        void top10FrequentWordsInGovernmentFakeNews(const List& list)
         {
-            WordFrequencyList wordFreqList;
+            topFrequentWordsInGovernmentFakeNews(list, 10);
+        }
+
+        // Same report for any k: words (stop words left out) are counted in a hash table and the top k picked with a
+        // bounded heap.
+        template <typename List>
+        void topFrequentWordsInGovernmentFakeNews(const List& list, size_t k)
+        {
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
+            WordCounter wordCounter;
+            WordTokenizer tokenizer;
             Article<string>* current = list.getHead();
             while (current != nullptr) 
             {
-                // For government news: check if Category contains "government" (case-insensitive) and Label is "fake"
-                string categoryLower = toLowercase(current->Category);
-                string labelLower = toLowercase(current->Label);
-                if (categoryLower.find("government") != string::npos && labelLower == "fake") 
+                // For government news: Category mentions "government" (any case) and Label is "fake".
+                if (categories.classOf(current->CategoryCode) == CATEGORY_GOVERNMENT && labels.classOf(current->LabelCode) == LABEL_FAKE) 
                 {
                     // Extract words from content and update word frequency statistics.
-                    extractWords(current->Content, wordFreqList);
+                    extractWords(current->Content, wordCounter, tokenizer);
                 }
                 current = current->next;
             }
-            // Sort by frequency from highest to lowest.
-            wordFreqList.sortByFrequency();
-            // Output the top 10 words.
-            cout << string(15,'-') << "Top 10 frequent words in fake government news." << string(15,'-') << endl;
-            WordFrequency* w = wordFreqList.getHead();
-            int count = 0;
-            while (w != nullptr && count < 10) 
+            // Output the top k words, highest frequency first.
+            cout << string(15,'-') << "Top " << k << " frequent words in fake government news." << string(15,'-') << endl;
+            vector<WordCount> top = wordCounter.topK(k);
+            for (size_t i = 0; i < top.size(); i++) 
             {
                 cout << string(15, '-') << endl;
-                cout << "Top " << (count + 1) << ": " << w->word << " : " << w->frequency << " times." << endl;
-                w = w->next;
-                count++;
+                cout << "Top " << (i + 1) << ": " << top[i].word << " : " << top[i].frequency << " times." << endl;
+            }
+        }
+
+        // Approximate top k words (n = 1) or n-grams of Content among the articles passing filter, counted in fixed
+        // memory: capacity counters of keyBytes each (see SpaceSaving). Each count is printed with its error bound.
+        template <typename List>
+        void topNgrams(const List& list, const AnalyticsFilter& filter, size_t n, size_t k, size_t capacity = 4096)
+        {
+            NgramHeavyHitters hitters(n, capacity, filter);
+            hitters.addAll(list);
+            const SpaceSaving& counts = hitters.counts();
+            cout << string(15,'-') << "Top " << k << (n == 1 ? " words" : " " + to_string(n) + "-grams") << string(15,'-') << endl;
+            vector<HeavyHitter> top = hitters.topK(k);
+            for (size_t i = 0; i < top.size(); i++)
+            {
+                cout << "Top " << (i + 1) << ": " << top[i].key << " : " << top[i].count << " times";
+                if (top[i].error > 0) cout << " (at least " << top[i].lowerBound() << ")";
+                if (!top[i].guaranteed) cout << " *";
+                cout << "." << endl;
+            }
+            cout << counts.totalCount() << " counted in " << hitters.articleCount() << " articles with " << counts.capacity()
+                 << " counters (" << counts.memoryUsage() / 1024 << " KB); counts are at most " << counts.maxError()
+                 << " too high." << endl;
+            if (any_of(top.begin(), top.end(), [](const HeavyHitter& hitter) { return !hitter.guaranteed; }))
+            {
+                cout << "* may not be in the true top " << k << "; more counters narrow the bounds." << endl;
             }
         }
 
         //--------- 4. Calculate the percentage of fake political news articles for each month in 2016..------------
-        void percentageFakePoliticalByMonth(LinkedList<string>& list) 
+        template <typename List>
+        void percentageFakePoliticalByMonth(const List& list)
         {
-            map<int, int> totalPoliticalPerMonth;
-            map<int, int> fakePoliticalPerMonth;
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
+            int totalPoliticalPerMonth[13] = {};
+            int fakePoliticalPerMonth[13] = {};
         
             Article<string>* current = list.getHead();
         
             while (current != nullptr) 
             {
-                // Extract year and month from the date
-                tm date = extract_date(current->Date);  // Ensure extract_date() parses the date correctly
-                int year = date.tm_year + 2000; // Adjust tm_year to represent the actual year
-                int month = date.tm_mon + 1;    // tm_mon starts at 0, so add 1
+                // Year and month come from the date key computed at import.
+                int year = date_year(current->DateKey);
+                int month = date_month(current->DateKey);
         
-                // Only consider political news from 2016
-                if (year == 2016 && (current->Category == "politics" || current->Category == "politicsNews")) 
+                // Only consider political news from 2016 (category and label codes were classified at import)
+                if (year == 2016 && month >= 1 && month <= 12 && categories.classOf(current->CategoryCode) == CATEGORY_POLITICAL) 
                 {
                     totalPoliticalPerMonth[month]++;
-        
-                    // Count fake news, ignoring case and spaces
-                    string label = current->Label;
-                    for (char& c : label) c = tolower(c);
-                    label.erase(0, label.find_first_not_of(" \t")); // Remove leading spaces
-                    label.erase(label.find_last_not_of(" \t") + 1);    // Remove trailing spaces
-        
-                    if (label == "fake") 
+                    if (labels.classOf(current->LabelCode) == LABEL_FAKE) 
                     {
                         fakePoliticalPerMonth[month]++;
                     }
                 }
                 current = current->next;
             }
-        
+            printFakePoliticalByMonth(totalPoliticalPerMonth, fakePoliticalPerMonth);
+        }
+
+        // Date index version: each month of 2016 is looked up as its own range, so other years are never visited.
+        void percentageFakePoliticalByMonth(const DateIndex& index)
+        {
+            const FieldDictionary& categories = category_dictionary();
+            const FieldDictionary& labels = label_dictionary();
+            int totalPoliticalPerMonth[13] = {};
+            int fakePoliticalPerMonth[13] = {};
+            for (int month = 1; month <= 12; month++)
+            {
+                DateIndex::Range days = index.monthRange(2016, month);
+                for (size_t position = days.begin; position < days.end; position++)
+                {
+                    const Article<string>* article = index.article(position);
+                    if (categories.classOf(article->CategoryCode) != CATEGORY_POLITICAL) continue;
+                    totalPoliticalPerMonth[month]++;
+                    if (labels.classOf(article->LabelCode) == LABEL_FAKE)
+                    {
+                        fakePoliticalPerMonth[month]++;
+                    }
+                }
+            }
+            printFakePoliticalByMonth(totalPoliticalPerMonth, fakePoliticalPerMonth);
+        }
+
+        void printFakePoliticalByMonth(const int totalPoliticalPerMonth[13], const int fakePoliticalPerMonth[13])
+        {
             cout << string(15,'-') << "Percentage of Fake Political News in 2016" << string(15,'-') << endl;
             for (int month = 1; month <= 12; month++) 
             {
@@ -532,7 +1430,8 @@ class LinearSearch
         }    
         
         //.------- 5. Search articles by keyword in the Content field and display the top 3 matching articles..------------
-        void searchArticlesByKeyword(const LinkedList<string>& newsList) 
+        template <typename List>
+        void searchArticlesByKeyword(const List& newsList)
         {
             // Prompt user for search criteria.
             cout << "Enter keyword (or leave empty to skip): ";
@@ -549,31 +1448,241 @@ class LinearSearch
             cout << "Enter year (or leave empty to skip): ";
             string year;
             getline(cin, year);
+            int yearValue = parse_year_filter(year);
         
             cout << "\nMatching articles (showing top 3):\n";
         
             // Traverse the linked list and output at most 3 matching articles.
+            vector<Article<string>*> found = findArticlesLinear(newsList, keyword, category, yearValue, 3);
+            for (Article<string>* current : found)
+            {
+                cout << "Title: " << current->Title << "\n"
+                     << "Category: " << current->Category << "\n"
+                     << "Date: " << current->Date << "\n"
+                     << "Label: " << current->Label << "\n\n";
+            }
+            if (found.empty()) 
+            {
+                cout << "No matching articles found." << endl;
+            }
+        }
+
+        // Linear keyword search: articles whose Content contains keyword (ASCII case-insensitive substring), filtered by
+        // category (ignoring case and spaces, empty = any) and year (0 = any). Returns at most limit articles in list order.
+        template <typename List>
+        vector<Article<string>*> findArticlesLinear(const List& newsList, const string& keyword,
+                                                    const string& category, int year, size_t limit)
+        {
+            CaseInsensitiveSearcher keywordSearcher(keyword);
+            FieldDictionary::Code categoryCode = category.empty() ? FieldDictionary::NOT_FOUND : category_dictionary().find(category);
+            vector<Article<string>*> found;
+            if (!category.empty() && categoryCode == FieldDictionary::NOT_FOUND) return found;
             Article<string>* current = newsList.getHead();
-            int count = 0;
-            while (current != nullptr && count < 3) 
+            while (current != nullptr && found.size() < limit) 
             {
-                bool matchKeyword = keyword.empty() || toLowercase(current->Content).find(keyword) != string::npos;
-                bool matchCategory = category.empty() || toLowercase(current->Category) == category;
-                bool matchYear = year.empty() || current->Date.find(year) != string::npos;
+                bool matchCategory = category.empty() || current->CategoryCode == categoryCode;
+                bool matchYear = year == 0 || date_year(current->DateKey) == year;
         
-                if (matchKeyword && matchCategory && matchYear) 
+                // The Content scan runs last, only for rows that pass the cheap filters.
+                if (matchCategory && matchYear && keywordSearcher.contains(current->Content)) 
                 {
-                    cout << "Title: " << current->Title << "\n"
-                         << "Category: " << current->Category << "\n"
-                         << "Date: " << current->Date << "\n"
-                         << "Label: " << current->Label << "\n\n";
-                    count++;
+                    found.push_back(current);
                 }
                 current = current->next;
             }
-            if (count == 0) 
+            return found;
+        }
+
+        // Same search over a date index built from the list: with a year filter only that year's range is scanned.
+        // Results come in date order, which is list order for a sorted list.
+        vector<Article<string>*> findArticlesLinear(const DateIndex& index, const string& keyword,
+                                                    const string& category, int year, size_t limit)
+        {
+            CaseInsensitiveSearcher keywordSearcher(keyword);
+            FieldDictionary::Code categoryCode = category.empty() ? FieldDictionary::NOT_FOUND : category_dictionary().find(category);
+            vector<Article<string>*> found;
+            if (year < 0 || (!category.empty() && categoryCode == FieldDictionary::NOT_FOUND)) return found;
+            DateIndex::Range range = year == 0 ? index.all() : index.yearRange(year);
+            for (size_t position = range.begin; position < range.end && found.size() < limit; position++)
+            {
+                Article<string>* article = index.article(position);
+                if ((category.empty() || article->CategoryCode == categoryCode) && keywordSearcher.contains(article->Content))
+                {
+                    found.push_back(article);
+                }
+            }
+            return found;
+        }
+
+        // Batch keyword search for watch lists: all keywords are matched in a single pass over each article's Content
+        // through an Aho-Corasick automaton, with the same matching (ASCII case-insensitive substring) and filters as
+        // findArticlesLinear. Returns one entry per keyword, in the order given, with no limit on the hits.
+        template <typename List>
+        vector<KeywordHits> findArticlesBatch(const List& newsList, const vector<string>& keywords,
+                                              const string& category, int year)
+        {
+            vector<KeywordHits> hits(keywords.size());
+            for (size_t k = 0; k < keywords.size(); k++)
+            {
+                hits[k].keyword = keywords[k];
+            }
+            FieldDictionary::Code categoryCode = category.empty() ? FieldDictionary::NOT_FOUND : category_dictionary().find(category);
+            if (keywords.empty() || (!category.empty() && categoryCode == FieldDictionary::NOT_FOUND)) return hits;
+
+            KeywordAutomaton automaton(keywords);
+            for (Article<string>* current = newsList.getHead(); current != nullptr; current = current->next)
+            {
+                if (!category.empty() && current->CategoryCode != categoryCode) continue;
+                if (year != 0 && date_year(current->DateKey) != year) continue;
+                automaton.forEachMatch(current->Content, [&](size_t k, size_t)
+                {
+                    KeywordHits& hit = hits[k];
+                    if (hit.articles.empty() || hit.articles.back() != current) hit.articles.push_back(current);
+                    hit.occurrences++;
+                });
+            }
+            return hits;
+        }
+
+        //.------- 6. Search articles by a watch list of keywords and report the hits per keyword..------------
+        template <typename List>
+        void searchArticlesByWatchList(const List& newsList)
+        {
+            cout << "Enter keywords separated by commas: ";
+            string line;
+            cin.ignore();
+            getline(cin, line);
+            vector<string> keywords;
+            stringstream ss(line);
+            string keyword;
+            while (getline(ss, keyword, ','))
+            {
+                size_t start = keyword.find_first_not_of(" \t");
+                size_t end = keyword.find_last_not_of(" \t");
+                if (start != string::npos) keywords.push_back(keyword.substr(start, end - start + 1));
+            }
+
+            cout << "Enter category (or leave empty to skip): ";
+            string category;
+            getline(cin, category);
+
+            cout << "Enter year (or leave empty to skip): ";
+            string year;
+            getline(cin, year);
+
+            for (const KeywordHits& hit : findArticlesBatch(newsList, keywords, category, parse_year_filter(year)))
+            {
+                cout << hit.keyword << ": " << hit.articles.size() << " articles, " << hit.occurrences << " matches" << endl;
+                if (!hit.articles.empty())
+                {
+                    cout << "  First: " << hit.articles.front()->Title << " (" << hit.articles.front()->Date << ")" << endl;
+                }
+            }
+        }
+
+        // Menu item: top words or n-grams for a category / label / year subset.
+        template <typename List>
+        void searchTopPhrases(const List& newsList)
+        {
+            cout << "Words per phrase (1-3): ";
+            size_t n = 1;
+            cin >> n;
+            cin.ignore();
+            if (n < 1 || n > 3)
+            {
+                cout << "Invalid phrase length." << endl;
+                return;
+            }
+
+            AnalyticsFilter filter;
+            cout << "Enter category (or leave empty to skip): ";
+            getline(cin, filter.category);
+
+            cout << "Enter label, true or fake (or leave empty to skip): ";
+            string label;
+            getline(cin, label);
+            filter.label = label.empty() ? LABEL_ANY : static_cast<ArticleLabel>(classify_label(FieldDictionary::normalize(label)));
+
+            cout << "Enter year (or leave empty to skip): ";
+            string year;
+            getline(cin, year);
+            filter.year = parse_year_filter(year);
+
+            topNgrams(newsList, filter, n, 10);
+        }
+
+        // Indexed keyword search: rows containing all (matchAll) or any of the keywords, filtered by category
+        // (ignoring case and spaces, empty = any) and year (0 = any, see parse_year_filter). Returns at most limit
+        // articles in index order. Keywords match whole tokens, not substrings.
+        vector<Article<string>*> findArticles(const InvertedIndex& index, const vector<string>& keywords, bool matchAll,
+                                              const string& category, int year, size_t limit)
+        {
+            FieldDictionary::Code categoryCode = category.empty() ? FieldDictionary::NOT_FOUND : category_dictionary().find(category);
+            auto matches = [&](const Article<string>* article)
+            {
+                return (category.empty() || article->CategoryCode == categoryCode) &&
+                       (year == 0 || date_year(article->DateKey) == year);
+            };
+
+            vector<Article<string>*> result;
+            if (!category.empty() && categoryCode == FieldDictionary::NOT_FOUND) return result;
+            if (keywords.empty())
+            {
+                for (InvertedIndex::RowId row = 0; row < index.getSize() && result.size() < limit; row++)
+                {
+                    if (matches(index.article(row))) result.push_back(index.article(row));
+                }
+                return result;
+            }
+
+            vector<InvertedIndex::RowId> rows = matchAll ? index.searchAll(keywords) : index.searchAny(keywords);
+            for (size_t i = 0; i < rows.size() && result.size() < limit; i++)
+            {
+                Article<string>* article = index.article(rows[i]);
+                if (matches(article)) result.push_back(article);
+            }
+            return result;
+        }
+
+        //.------- 5b. Search articles by several keywords through the inverted index..------------
+        void searchArticlesByKeyword(const InvertedIndex& index)
+        {
+            cout << "Enter keywords separated by spaces (or leave empty to skip): ";
+            string line;
+            cin.ignore();
+            getline(cin, line);
+            vector<string> keywords;
+            InvertedIndex::forEachToken(line, [&](const string& token) { keywords.push_back(token); });
+
+            bool matchAll = true;
+            if (keywords.size() > 1)
+            {
+                cout << "Match all keywords or any keyword? (all/any): ";
+                string mode;
+                getline(cin, mode);
+                matchAll = toLowercase(mode) != "any";
+            }
+
+            cout << "Enter category (or leave empty to skip): ";
+            string category;
+            getline(cin, category);
+
+            cout << "Enter year (or leave empty to skip): ";
+            string year;
+            getline(cin, year);
+
+            cout << "\nMatching articles (showing top 3):\n";
+            vector<Article<string>*> found = findArticles(index, keywords, matchAll, category, parse_year_filter(year), 3);
+            for (Article<string>* article : found)
+            {
+                cout << "Title: " << article->Title << "\n"
+                     << "Category: " << article->Category << "\n"
+                     << "Date: " << article->Date << "\n"
+                     << "Label: " << article->Label << "\n\n";
+            }
+            if (found.empty())
             {
                 cout << "No matching articles found." << endl;
             }
-        }        
+        }
 };
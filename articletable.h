@@ -0,0 +1,589 @@
+#ifndef ARTICLETABLE_H
+#define ARTICLETABLE_H
+
+#include "linkedlist.h"
+#include "dictionary.h"
+#include "csvreader.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+enum ArticleField { FIELD_TITLE, FIELD_CONTENT, FIELD_CATEGORY, FIELD_DATE, FIELD_LABEL, FIELD_COUNT };
+
+//Fixed-size header at the start of a snapshot file. All sections follow it, each 8-byte aligned, at the
+//recorded offsets; numbers are stored in the writer's byte order (byteOrder tells a reader if it differs).
+struct SnapshotHeader
+{
+    char magic[8];           // "NEWSSNAP"
+    uint32_t version;
+    uint32_t byteOrder;      // 0x01020304 as written
+    uint64_t rows;
+    uint64_t fileBytes;
+    uint64_t sourceBytes;    // Size of the CSV the snapshot was built from
+    int64_t sourceModified;  // ... and its modification time (filesystem clock ticks)
+    uint64_t offsetsAt[FIELD_COUNT]; // uint64_t per row
+    uint64_t lengthsAt[FIELD_COUNT]; // uint32_t per row
+    uint64_t dateKeysAt;             // int32_t per row
+    uint64_t categoryCodesAt;        // uint16_t per row
+    uint64_t labelCodesAt;           // uint16_t per row
+    uint64_t arenaAt;
+    uint64_t arenaBytes;
+    uint64_t dictionaryAt;           // Category values, then Label values: uint32_t count, then uint32_t length + bytes each
+    uint64_t dictionaryBytes;
+};
+
+//Columnar article store: every field is a column of offsets/lengths into one shared arena, and rows are
+//addressed by a 32-bit row id. A scan over one field only reads that field's column and bytes.
+//A table either owns its columns or views them in a memory-mapped snapshot file (see loadSnapshot), in which
+//case it is read-only and nothing is copied at load time.
+class ArticleTable
+{
+    public:
+        typedef uint32_t RowId;
+
+        static const uint32_t SNAPSHOT_VERSION = 1;
+
+        ArticleTable()
+        {
+            refresh();
+        }
+
+        ArticleTable(const ArticleTable& other)
+            : arena(other.arena), dateKeys(other.dateKeys), categoryCodes(other.categoryCodes), labelCodes(other.labelCodes),
+              snapshot(other.snapshot), view(other.view)
+        {
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                offsets[f] = other.offsets[f];
+                lengths[f] = other.lengths[f];
+            }
+            refresh();
+        }
+
+        ArticleTable(ArticleTable&& other) noexcept
+        {
+            take(other);
+        }
+
+        ArticleTable& operator=(const ArticleTable& other)
+        {
+            if (this != &other)
+            {
+                ArticleTable copy(other);
+                take(copy);
+            }
+            return *this;
+        }
+
+        ArticleTable& operator=(ArticleTable&& other) noexcept
+        {
+            if (this != &other)
+            {
+                take(other);
+            }
+            return *this;
+        }
+
+        //Build a table from a list. The arena is laid out column by column (all titles, then all contents, ...)
+        //so the bytes of a short field such as Label are contiguous across rows.
+        static ArticleTable fromList(const LinkedList<string>& list)
+        {
+            ArticleTable table;
+            size_t rows = list.getSize();
+            check_row_count(rows);
+
+            size_t columnBytes[FIELD_COUNT] = {};
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                for (int f = 0; f < FIELD_COUNT; f++)
+                {
+                    columnBytes[f] += field_of(*node, static_cast<ArticleField>(f)).size();
+                }
+            }
+
+            size_t totalBytes = 0;
+            for (int f = 0; f < FIELD_COUNT; f++) totalBytes += columnBytes[f];
+            table.arena.resize(totalBytes);
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                table.offsets[f].reserve(rows);
+                table.lengths[f].reserve(rows);
+            }
+            table.dateKeys.reserve(rows);
+            table.categoryCodes.reserve(rows);
+            table.labelCodes.reserve(rows);
+
+            size_t cursor = 0;
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                for (Article<string>* node = list.getHead(); node; node = node->next)
+                {
+                    const string& value = field_of(*node, static_cast<ArticleField>(f));
+                    check_field_length(value.size());
+                    value.copy(&table.arena[cursor], value.size());
+                    table.offsets[f].push_back(cursor);
+                    table.lengths[f].push_back(static_cast<uint32_t>(value.size()));
+                    cursor += value.size();
+                }
+            }
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                table.dateKeys.push_back(node->DateKey);
+                table.categoryCodes.push_back(node->CategoryCode);
+                table.labelCodes.push_back(node->LabelCode);
+            }
+            table.refresh();
+            return table;
+        }
+
+        void reserve(size_t rows, size_t arenaBytes)
+        {
+            check_writable();
+            check_row_count(rows);
+            arena.reserve(arenaBytes);
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                offsets[f].reserve(rows);
+                lengths[f].reserve(rows);
+            }
+            dateKeys.reserve(rows);
+            categoryCodes.reserve(rows);
+            labelCodes.reserve(rows);
+            refresh();
+        }
+
+        //Append one row; its field bytes are appended to the end of the arena.
+        RowId appendRow(string_view Title, string_view Content, string_view Category, string_view Date, string_view Label, int DateKey)
+        {
+            check_writable();
+            check_row_count(dateKeys.size() + 1);
+            const string_view values[FIELD_COUNT] = { Title, Content, Category, Date, Label };
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                check_field_length(values[f].size());
+                offsets[f].push_back(arena.size());
+                lengths[f].push_back(static_cast<uint32_t>(values[f].size()));
+                arena.insert(arena.end(), values[f].begin(), values[f].end());
+            }
+            dateKeys.push_back(DateKey);
+            categoryCodes.push_back(category_dictionary().intern(Category));
+            labelCodes.push_back(label_dictionary().intern(Label));
+            refresh();
+            return static_cast<RowId>(dateKeys.size() - 1);
+        }
+
+        //Views stay valid until the next appendRow().
+        string_view field(RowId row, ArticleField f) const
+        {
+            return string_view(view.arena + view.offsets[f][row], view.lengths[f][row]);
+        }
+
+        string_view title(RowId row) const { return field(row, FIELD_TITLE); }
+        string_view content(RowId row) const { return field(row, FIELD_CONTENT); }
+        string_view category(RowId row) const { return field(row, FIELD_CATEGORY); }
+        string_view date(RowId row) const { return field(row, FIELD_DATE); }
+        string_view label(RowId row) const { return field(row, FIELD_LABEL); }
+        int dateKey(RowId row) const { return view.dateKeys[row]; }
+        FieldDictionary::Code categoryCode(RowId row) const { return view.categoryCodes[row]; }
+        FieldDictionary::Code labelCode(RowId row) const { return view.labelCodes[row]; }
+
+        size_t getSize() const
+        {
+            return view.rows;
+        }
+
+        //Bytes held by the arena and the columns (for a snapshot table: the mapped file).
+        size_t memoryUsage() const
+        {
+            size_t bytes = sizeof(*this) + arena.capacity() + dateKeys.capacity() * sizeof(int32_t)
+                         + (categoryCodes.capacity() + labelCodes.capacity()) * sizeof(FieldDictionary::Code);
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                bytes += offsets[f].capacity() * sizeof(uint64_t) + lengths[f].capacity() * sizeof(uint32_t);
+            }
+            return bytes + (snapshot ? snapshot->size() : 0);
+        }
+
+        void clear()
+        {
+            snapshot.reset();
+            arena.clear();
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                offsets[f].clear();
+                lengths[f].clear();
+            }
+            dateKeys.clear();
+            categoryCodes.clear();
+            labelCodes.clear();
+            refresh();
+        }
+
+        bool isSnapshot() const
+        {
+            return snapshot != nullptr;
+        }
+
+        //Size and modification time of the CSV a snapshot table was built from (0 for other tables).
+        uint64_t snapshotSourceBytes() const { return snapshot ? header().sourceBytes : 0; }
+        int64_t snapshotSourceModified() const { return snapshot ? header().sourceModified : 0; }
+
+        //Write the table as a snapshot file that loadSnapshot() can map. sourceBytes and sourceModified
+        //identify the CSV it was built from, so a reader can tell when it is out of date.
+        void saveSnapshot(const string& path, uint64_t sourceBytes, int64_t sourceModified) const
+        {
+            const size_t rows = view.rows;
+            string dictionary;
+            append_dictionary(dictionary, category_dictionary());
+            append_dictionary(dictionary, label_dictionary());
+            size_t arenaBytes = snapshot ? header().arenaBytes : arena.size();
+
+            SnapshotHeader h = {};
+            memcpy(h.magic, "NEWSSNAP", 8);
+            h.version = SNAPSHOT_VERSION;
+            h.byteOrder = 0x01020304;
+            h.rows = rows;
+            h.sourceBytes = sourceBytes;
+            h.sourceModified = sourceModified;
+            uint64_t at = aligned(sizeof(SnapshotHeader));
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                h.offsetsAt[f] = at;
+                at = aligned(at + rows * sizeof(uint64_t));
+                h.lengthsAt[f] = at;
+                at = aligned(at + rows * sizeof(uint32_t));
+            }
+            h.dateKeysAt = at;
+            at = aligned(at + rows * sizeof(int32_t));
+            h.categoryCodesAt = at;
+            at = aligned(at + rows * sizeof(FieldDictionary::Code));
+            h.labelCodesAt = at;
+            at = aligned(at + rows * sizeof(FieldDictionary::Code));
+            h.arenaAt = at;
+            h.arenaBytes = arenaBytes;
+            at = aligned(at + arenaBytes);
+            h.dictionaryAt = at;
+            h.dictionaryBytes = dictionary.size();
+            h.fileBytes = aligned(at + dictionary.size());
+
+            // Written to a temporary name and renamed, so a reader never maps a half-written file.
+            string temporary = path + ".tmp";
+            {
+                ofstream out(temporary, ios::binary | ios::trunc);
+                if (!out.is_open())
+                {
+                    throw runtime_error("Could not open " + temporary + " for writing.");
+                }
+                uint64_t written = 0;
+                auto put = [&](uint64_t offset, const void* data, size_t size)
+                {
+                    static const char zeros[8] = {};
+                    while (written < offset)
+                    {
+                        size_t pad = static_cast<size_t>(min<uint64_t>(offset - written, sizeof(zeros)));
+                        out.write(zeros, pad);
+                        written += pad;
+                    }
+                    if (size > 0) out.write(static_cast<const char*>(data), static_cast<streamsize>(size));
+                    written += size;
+                };
+                put(0, &h, sizeof(h));
+                for (int f = 0; f < FIELD_COUNT; f++)
+                {
+                    put(h.offsetsAt[f], view.offsets[f], rows * sizeof(uint64_t));
+                    put(h.lengthsAt[f], view.lengths[f], rows * sizeof(uint32_t));
+                }
+                put(h.dateKeysAt, view.dateKeys, rows * sizeof(int32_t));
+                put(h.categoryCodesAt, view.categoryCodes, rows * sizeof(FieldDictionary::Code));
+                put(h.labelCodesAt, view.labelCodes, rows * sizeof(FieldDictionary::Code));
+                put(h.arenaAt, view.arena, arenaBytes);
+                put(h.dictionaryAt, dictionary.data(), dictionary.size());
+                put(h.fileBytes, nullptr, 0);
+                out.close();
+                if (out.fail())
+                {
+                    throw runtime_error("Failed to write " + temporary + ".");
+                }
+            }
+            remove(path.c_str());
+            if (rename(temporary.c_str(), path.c_str()) != 0)
+            {
+                throw runtime_error("Failed to rename " + temporary + " to " + path + ".");
+            }
+        }
+
+        //Map a snapshot file and use its columns in place. The header and section bounds are checked, and so is
+        //every row (rows_in_bounds): each field's offset + length must lie within the string arena and each code
+        //within the stored dictionary, so loading is O(rows) rather than a plain mapping. Category and Label
+        //values are interned into this process's dictionaries, and only if that numbers them differently from
+        //the writer are the two code columns copied and renumbered.
+        //Throws runtime_error if the file is missing, of another version or malformed.
+        static ArticleTable loadSnapshot(const string& path)
+        {
+            ArticleTable table;
+            table.snapshot = make_shared<MappedFile>(path);
+            const char* base = table.snapshot->data();
+            size_t size = table.snapshot->size();
+            if (size < sizeof(SnapshotHeader) || memcmp(base, "NEWSSNAP", 8) != 0)
+            {
+                throw runtime_error(path + " is not a snapshot file.");
+            }
+            const SnapshotHeader& h = table.header();
+            if (h.byteOrder != 0x01020304 || h.version != SNAPSHOT_VERSION)
+            {
+                throw runtime_error(path + " was written by an incompatible version.");
+            }
+            uint64_t rows = h.rows;
+            bool valid = h.fileBytes == size && rows <= UINT32_MAX &&
+                         section_fits(h.dateKeysAt, rows * sizeof(int32_t), size) &&
+                         section_fits(h.categoryCodesAt, rows * sizeof(FieldDictionary::Code), size) &&
+                         section_fits(h.labelCodesAt, rows * sizeof(FieldDictionary::Code), size) &&
+                         section_fits(h.arenaAt, h.arenaBytes, size) &&
+                         section_fits(h.dictionaryAt, h.dictionaryBytes, size);
+            for (int f = 0; f < FIELD_COUNT && valid; f++)
+            {
+                valid = section_fits(h.offsetsAt[f], rows * sizeof(uint64_t), size) &&
+                        section_fits(h.lengthsAt[f], rows * sizeof(uint32_t), size);
+            }
+            if (!valid)
+            {
+                throw runtime_error(path + " is truncated or corrupt.");
+            }
+
+            table.view.rows = static_cast<size_t>(rows);
+            table.view.arena = base + h.arenaAt;
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                table.view.offsets[f] = reinterpret_cast<const uint64_t*>(base + h.offsetsAt[f]);
+                table.view.lengths[f] = reinterpret_cast<const uint32_t*>(base + h.lengthsAt[f]);
+            }
+            table.view.dateKeys = reinterpret_cast<const int32_t*>(base + h.dateKeysAt);
+            table.view.categoryCodes = reinterpret_cast<const FieldDictionary::Code*>(base + h.categoryCodesAt);
+            table.view.labelCodes = reinterpret_cast<const FieldDictionary::Code*>(base + h.labelCodesAt);
+
+            const char* dictionary = base + h.dictionaryAt;
+            const char* dictionaryEnd = dictionary + h.dictionaryBytes;
+            vector<FieldDictionary::Code> categoryMap = read_dictionary(dictionary, dictionaryEnd, category_dictionary());
+            vector<FieldDictionary::Code> labelMap = read_dictionary(dictionary, dictionaryEnd, label_dictionary());
+            if (!table.rows_in_bounds(h.arenaBytes, categoryMap.size(), labelMap.size()))
+            {
+                throw runtime_error(path + " is truncated or corrupt.");
+            }
+            table.renumber(table.categoryCodes, table.view.categoryCodes, categoryMap);
+            table.renumber(table.labelCodes, table.view.labelCodes, labelMap);
+            table.refresh();
+            return table;
+        }
+
+    private:
+        vector<char> arena;
+        vector<uint64_t> offsets[FIELD_COUNT];
+        vector<uint32_t> lengths[FIELD_COUNT];
+        vector<int32_t> dateKeys;
+        vector<FieldDictionary::Code> categoryCodes;
+        vector<FieldDictionary::Code> labelCodes;
+        shared_ptr<MappedFile> snapshot;
+
+        // What the accessors read: the vectors above, or the sections of a mapped snapshot.
+        struct Columns
+        {
+            const char* arena = nullptr;
+            const uint64_t* offsets[FIELD_COUNT] = {};
+            const uint32_t* lengths[FIELD_COUNT] = {};
+            const int32_t* dateKeys = nullptr;
+            const FieldDictionary::Code* categoryCodes = nullptr;
+            const FieldDictionary::Code* labelCodes = nullptr;
+            size_t rows = 0;
+        };
+        Columns view;
+
+        // Point the view at the owned vectors (for a snapshot, only at code columns that were renumbered).
+        void refresh()
+        {
+            if (!snapshot)
+            {
+                view.arena = arena.data();
+                for (int f = 0; f < FIELD_COUNT; f++)
+                {
+                    view.offsets[f] = offsets[f].data();
+                    view.lengths[f] = lengths[f].data();
+                }
+                view.dateKeys = dateKeys.data();
+                view.rows = dateKeys.size();
+            }
+            if (!snapshot || !categoryCodes.empty()) view.categoryCodes = categoryCodes.data();
+            if (!snapshot || !labelCodes.empty()) view.labelCodes = labelCodes.data();
+        }
+
+        void take(ArticleTable& other)
+        {
+            arena = move(other.arena);
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                offsets[f] = move(other.offsets[f]);
+                lengths[f] = move(other.lengths[f]);
+            }
+            dateKeys = move(other.dateKeys);
+            categoryCodes = move(other.categoryCodes);
+            labelCodes = move(other.labelCodes);
+            snapshot = move(other.snapshot);
+            view = other.view;
+            refresh();
+            other.clear();
+        }
+
+        const SnapshotHeader& header() const
+        {
+            return *reinterpret_cast<const SnapshotHeader*>(snapshot->data());
+        }
+
+        static uint64_t aligned(uint64_t offset)
+        {
+            return (offset + 7) & ~uint64_t(7);
+        }
+
+        static bool section_fits(uint64_t at, uint64_t bytes, size_t fileBytes)
+        {
+            return at % 8 == 0 && at <= fileBytes && bytes <= fileBytes - at;
+        }
+
+        static void append_dictionary(string& out, const FieldDictionary& dictionary)
+        {
+            uint32_t count = static_cast<uint32_t>(dictionary.size());
+            out.append(reinterpret_cast<const char*>(&count), sizeof(count));
+            for (uint32_t code = 0; code < count; code++)
+            {
+                const string& text = dictionary.text(static_cast<FieldDictionary::Code>(code));
+                uint32_t length = static_cast<uint32_t>(text.size());
+                out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+                out.append(text);
+            }
+        }
+
+        // Intern a stored dictionary; returns stored code -> process code.
+        static vector<FieldDictionary::Code> read_dictionary(const char*& p, const char* end, FieldDictionary& dictionary)
+        {
+            uint32_t count;
+            if (end - p < 4) throw runtime_error("Snapshot dictionary is truncated.");
+            memcpy(&count, p, sizeof(count));
+            p += sizeof(count);
+            vector<FieldDictionary::Code> codes;
+            codes.reserve(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t length;
+                if (end - p < 4) throw runtime_error("Snapshot dictionary is truncated.");
+                memcpy(&length, p, sizeof(length));
+                p += sizeof(length);
+                if (static_cast<uint64_t>(end - p) < length) throw runtime_error("Snapshot dictionary is truncated.");
+                codes.push_back(dictionary.intern(string_view(p, length)));
+                p += length;
+            }
+            return codes;
+        }
+
+        // Copy a mapped code column through map, unless map is the identity.
+        void renumber(vector<FieldDictionary::Code>& column, const FieldDictionary::Code* stored, const vector<FieldDictionary::Code>& map)
+        {
+            bool identity = true;
+            for (size_t code = 0; code < map.size() && identity; code++)
+            {
+                identity = map[code] == code;
+            }
+            if (identity) return;
+            column.resize(view.rows);
+            for (size_t row = 0; row < view.rows; row++)
+            {
+                column[row] = stored[row] < map.size() ? map[stored[row]] : 0;
+            }
+        }
+
+        // Every field of every row lies inside the arena and every code is in its stored dictionary, so the
+        // accessors of a mapped snapshot never read outside it. One pass over the offset, length and code columns.
+        bool rows_in_bounds(uint64_t arenaBytes, size_t categoryCount, size_t labelCount) const
+        {
+            for (int f = 0; f < FIELD_COUNT; f++)
+            {
+                const uint64_t* fieldOffsets = view.offsets[f];
+                const uint32_t* fieldLengths = view.lengths[f];
+                for (size_t row = 0; row < view.rows; row++)
+                {
+                    if (fieldOffsets[row] > arenaBytes || fieldLengths[row] > arenaBytes - fieldOffsets[row]) return false;
+                }
+            }
+            for (size_t row = 0; row < view.rows; row++)
+            {
+                if (view.categoryCodes[row] >= categoryCount || view.labelCodes[row] >= labelCount) return false;
+            }
+            return true;
+        }
+
+        void check_writable() const
+        {
+            if (snapshot)
+            {
+                throw logic_error("A table loaded from a snapshot is read-only.");
+            }
+        }
+
+        static const string& field_of(const Article<string>& article, ArticleField f)
+        {
+            switch (f)
+            {
+                case FIELD_TITLE: return article.Title;
+                case FIELD_CONTENT: return article.Content;
+                case FIELD_CATEGORY: return article.Category;
+                case FIELD_DATE: return article.Date;
+                default: return article.Label;
+            }
+        }
+
+        static void check_row_count(size_t rows)
+        {
+            if (rows > UINT32_MAX)
+            {
+                throw length_error("ArticleTable supports at most 2^32 rows.");
+            }
+        }
+
+        static void check_field_length(size_t length)
+        {
+            if (length > UINT32_MAX)
+            {
+                throw length_error("ArticleTable field is longer than 4 GB.");
+            }
+        }
+};
+
+//Approximate heap footprint of the node-based list: each node (allocated from pool blocks) plus the heap buffer
+//of every string that does not fit the small-string buffer, with 16 bytes of allocator overhead per string
+//allocation. Used to compare against ArticleTable::memoryUsage().
+size_t list_memory_usage(const LinkedList<string>& list)
+{
+    const size_t allocOverhead = 16;
+    const size_t inlineCapacity = string().capacity();
+    size_t bytes = sizeof(list);
+    for (Article<string>* node = list.getHead(); node; node = node->next)
+    {
+        bytes += sizeof(Article<string>);
+        const string* fields[] = { &node->Title, &node->Content, &node->Category, &node->Date, &node->Label };
+        for (const string* value : fields)
+        {
+            if (value->capacity() > inlineCapacity)
+            {
+                bytes += value->capacity() + 1 + allocOverhead;
+            }
+        }
+    }
+    return bytes;
+}
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CSV_USE_SSE2 1
+#endif
+
+using namespace std;
+
+//Read-only memory mapping of a whole file.
+class MappedFile
+{
+    public:
+        explicit MappedFile(const string& path)
+        {
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw runtime_error("Failed to open the file: " + path);
+            }
+            LARGE_INTEGER fileSize;
+            GetFileSizeEx(file, &fileSize);
+            length = static_cast<size_t>(fileSize.QuadPart);
+            if (length > 0)
+            {
+                mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr)
+                {
+                    bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                }
+                if (bytes == nullptr)
+                {
+                    release();
+                    throw runtime_error("Failed to map the file: " + path);
+                }
+            }
+#else
+            fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw runtime_error("Failed to open the file: " + path);
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0)
+            {
+                release();
+                throw runtime_error("Failed to read the size of: " + path);
+            }
+            length = static_cast<size_t>(info.st_size);
+            if (length > 0)
+            {
+                void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view == MAP_FAILED)
+                {
+                    release();
+                    throw runtime_error("Failed to map the file: " + path);
+                }
+                bytes = static_cast<const char*>(view);
+                madvise(view, length, MADV_SEQUENTIAL);
+            }
+#endif
+        }
+
+        ~MappedFile()
+        {
+            release();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+
+    private:
+        const char* bytes = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int fd = -1;
+#endif
+
+        void release()
+        {
+#ifdef _WIN32
+            if (bytes) UnmapViewOfFile(bytes);
+            if (mapping) CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (bytes) munmap(const_cast<char*>(bytes), length);
+            if (fd >= 0) close(fd);
+            fd = -1;
+#endif
+            bytes = nullptr;
+        }
+};
+
+//Find the first ',' or '\n' in [p, end), or end if there is none. Scans 16 bytes at a time when SSE2 is available.
+const char* find_csv_delimiter(const char* p, const char* end)
+{
+#ifdef CSV_USE_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline)));
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != ',' && *p != '\n')
+    {
+        p++;
+    }
+    return p;
+}
+
+//RFC 4180 reader over an in-memory buffer (normally a MappedFile). Fields are returned as views into the
+//buffer; only a quoted field that contains doubled quotes ("") is copied, unescaped, into scratch space.
+//Quoted fields may contain commas and newlines. CRLF line endings are accepted.
+class CsvReader
+{
+    public:
+        CsvReader(const char* begin, const char* end) : p(begin), end(end) {}
+
+        //Read the next record into fields. Returns false when the input is exhausted.
+        //The views stay valid until the next call (or for as long as the buffer, if the field was not escaped).
+        bool next(vector<string_view>& fields)
+        {
+            fields.clear();
+            if (p >= end)
+            {
+                return false;
+            }
+
+            while (true)
+            {
+                if (p == end)
+                {
+                    // Trailing comma at end of input: one last empty field.
+                    fields.push_back(string_view());
+                    break;
+                }
+
+                string_view field;
+                if (*p == '"')
+                {
+                    field = read_quoted(fields.size());
+                    // Anything between the closing quote and the delimiter is ignored.
+                    p = find_csv_delimiter(p, end);
+                }
+                else
+                {
+                    const char* stop = find_csv_delimiter(p, end);
+                    field = string_view(p, stop - p);
+                    if (!field.empty() && field.back() == '\r' && (stop == end || *stop == '\n'))
+                    {
+                        field.remove_suffix(1);
+                    }
+                    p = stop;
+                }
+                fields.push_back(field);
+
+                if (p == end)
+                {
+                    break;
+                }
+                if (*p++ == '\n')
+                {
+                    break;
+                }
+            }
+            records++;
+            return true;
+        }
+
+        //Number of records returned so far (the header counts as one).
+        size_t recordCount() const
+        {
+            return records;
+        }
+
+        //Current read position, for callers that split the buffer between readers.
+        const char* position() const
+        {
+            return p;
+        }
+
+        //True once a quoted field ran to the end of the buffer without its closing quote.
+        bool unterminatedQuote() const
+        {
+            return unterminated;
+        }
+
+    private:
+        const char* p;
+        const char* end;
+        size_t records = 0;
+        bool unterminated = false;
+        deque<string> scratch; //One buffer per field index; deque keeps earlier views valid while it grows.
+
+        string_view read_quoted(size_t fieldIndex)
+        {
+            const char* start = ++p;
+            bool escaped = false;
+            const char* close = end;
+            while (p < end)
+            {
+                const char* quote = static_cast<const char*>(memchr(p, '"', end - p));
+                if (quote == nullptr)
+                {
+                    break;
+                }
+                if (quote + 1 < end && quote[1] == '"')
+                {
+                    escaped = true;
+                    p = quote + 2;
+                    continue;
+                }
+                close = quote;
+                break;
+            }
+            p = (close == end) ? end : close + 1;
+            unterminated = unterminated || close == end;
+
+            if (!escaped)
+            {
+                return string_view(start, close - start);
+            }
+
+            while (scratch.size() <= fieldIndex)
+            {
+                scratch.emplace_back();
+            }
+            string& buffer = scratch[fieldIndex];
+            buffer.clear();
+            for (const char* c = start; c < close; c++)
+            {
+                buffer.push_back(*c);
+                if (*c == '"')
+                {
+                    c++; // Skip the second quote of the pair.
+                }
+            }
+            return buffer;
+        }
+};
+
+#endif
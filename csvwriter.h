@@ -0,0 +1,127 @@
+#ifndef CSVWRITER_H
+#define CSVWRITER_H
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+
+using namespace std;
+
+//Append one field to a CSV line with RFC 4180 escaping: a field containing a comma, a quote, CR or LF is
+//wrapped in quotes and its quotes are doubled; any other field is copied as is.
+void append_csv_field(string& out, string_view field)
+{
+    size_t special = field.find_first_of(",\"\r\n");
+    if (special == string_view::npos)
+    {
+        out.append(field.data(), field.size());
+        return;
+    }
+    out.push_back('"');
+    out.append(field.data(), special);
+    for (size_t i = special; i < field.size(); i++)
+    {
+        if (field[i] == '"') out.push_back('"');
+        out.push_back(field[i]);
+    }
+    out.push_back('"');
+}
+
+//Append a whole record (fields joined by commas, terminated by '\n').
+void append_csv_row(string& out, initializer_list<string_view> fields)
+{
+    bool first = true;
+    for (string_view field : fields)
+    {
+        if (!first) out.push_back(',');
+        append_csv_field(out, field);
+        first = false;
+    }
+    out.push_back('\n');
+}
+
+//Buffered CSV file writer. Records are formatted into a user-space buffer that is written out in large
+//blocks, so the number of write calls does not depend on the number of fields. Throws runtime_error when
+//the file cannot be opened or a write fails.
+class CsvWriter
+{
+    public:
+        explicit CsvWriter(const string& filename, size_t bufferSize = 1 << 22)
+            : file(filename, ios::binary), bufferSize(bufferSize)
+        {
+            if (!file.is_open())
+            {
+                throw runtime_error("Could not open " + filename + " for writing.");
+            }
+            buffer.reserve(bufferSize + 4096);
+        }
+
+        ~CsvWriter()
+        {
+            // Errors while closing from a destructor are dropped; call close() to see them.
+            try
+            {
+                close();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        CsvWriter(const CsvWriter&) = delete;
+        CsvWriter& operator=(const CsvWriter&) = delete;
+
+        void writeRow(initializer_list<string_view> fields)
+        {
+            append_csv_row(buffer, fields);
+            if (buffer.size() >= bufferSize) flush();
+        }
+
+        //Write records that were already formatted (e.g. by another thread) after the buffered ones.
+        void writeFormatted(string_view rows)
+        {
+            if (buffer.size() + rows.size() < bufferSize)
+            {
+                buffer.append(rows.data(), rows.size());
+                return;
+            }
+            flush();
+            writeBytes(rows.data(), rows.size());
+        }
+
+        void flush()
+        {
+            writeBytes(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+
+        void close()
+        {
+            if (!file.is_open()) return;
+            flush();
+            file.close();
+            if (file.fail())
+            {
+                throw runtime_error("Failed to finish writing the CSV file.");
+            }
+        }
+
+    private:
+        ofstream file;
+        string buffer;
+        size_t bufferSize;
+
+        void writeBytes(const char* data, size_t size)
+        {
+            if (size == 0) return;
+            file.write(data, static_cast<streamsize>(size));
+            if (!file)
+            {
+                throw runtime_error("Failed to write the CSV file.");
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef DATEINDEX_H
+#define DATEINDEX_H
+
+#include "linkedlist.h"
+#include "articletable.h"
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//Date index: the rows of a list or table ordered by date key, so the articles of a date range are found with two
+//binary searches and visited without scanning the rest. Built after sorting, the index order is the list order
+//and building is a single pass; an unsorted source is sorted here (stably, so equal dates keep source order).
+//Positions are places in date order; rows are source row numbers (list order or table row ids).
+class DateIndex
+{
+    public:
+        typedef uint32_t RowId;
+
+        //Positions [begin, end) of a date range.
+        struct Range
+        {
+            size_t begin = 0;
+            size_t end = 0;
+
+            size_t size() const { return end - begin; }
+            bool empty() const { return begin == end; }
+        };
+
+        //Index a list; article() is available afterwards.
+        void build(const LinkedList<string>& list)
+        {
+            clear();
+            check_row_count(list.getSize());
+            keys.reserve(list.getSize());
+            articles.reserve(list.getSize());
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                keys.push_back(node->DateKey);
+                articles.push_back(node);
+            }
+            order_rows();
+        }
+
+        //Index a table by row id.
+        void build(const ArticleTable& table)
+        {
+            clear();
+            check_row_count(table.getSize());
+            keys.reserve(table.getSize());
+            for (ArticleTable::RowId row = 0; row < table.getSize(); row++)
+            {
+                keys.push_back(table.dateKey(row));
+            }
+            order_rows();
+        }
+
+        //Positions of the date keys in [fromKey, toKey] (yyyymmdd, both inclusive).
+        Range range(int fromKey, int toKey) const
+        {
+            Range result;
+            if (fromKey > toKey) return result;
+            result.begin = lower_bound(keys.begin(), keys.end(), fromKey) - keys.begin();
+            result.end = upper_bound(keys.begin() + result.begin, keys.end(), toKey) - keys.begin();
+            return result;
+        }
+
+        Range yearRange(int year) const
+        {
+            return range(year * 10000, year * 10000 + 9999);
+        }
+
+        Range monthRange(int year, int month) const
+        {
+            return range(year * 10000 + month * 100, year * 10000 + month * 100 + 99);
+        }
+
+        Range all() const
+        {
+            Range result;
+            result.end = keys.size();
+            return result;
+        }
+
+        int dateKey(size_t position) const
+        {
+            return keys[position];
+        }
+
+        RowId row(size_t position) const
+        {
+            return rows.empty() ? static_cast<RowId>(position) : rows[position];
+        }
+
+        //Article at a position; only for an index built from a list.
+        Article<string>* article(size_t position) const
+        {
+            return articles[row(position)];
+        }
+
+        bool hasArticles() const
+        {
+            return !articles.empty() || keys.empty();
+        }
+
+        //Add date-sorted articles that are being merged into the indexed (sorted) list with LinkedList::merge_sorted,
+        //so positions keep matching the list without a rebuild. Existing entries stay ahead of equal new dates.
+        //The merge runs from the back and stops at the first new date, so a batch of newer articles costs O(batch).
+        void insertSorted(const vector<Article<string>*>& added)
+        {
+            if (!hasArticles() || !inSourceOrder())
+            {
+                throw logic_error("DateIndex::insertSorted needs an index built from a sorted list.");
+            }
+            for (size_t j = 1; j < added.size(); j++)
+            {
+                if (added[j]->DateKey < added[j - 1]->DateKey)
+                {
+                    throw invalid_argument("DateIndex::insertSorted: the articles are not in date order.");
+                }
+            }
+            check_row_count(keys.size() + added.size());
+
+            size_t i = keys.size(), j = added.size(), out = keys.size() + added.size();
+            keys.resize(out);
+            articles.resize(out);
+            while (j > 0)
+            {
+                out--;
+                if (i > 0 && keys[i - 1] > added[j - 1]->DateKey)
+                {
+                    i--;
+                    keys[out] = keys[i];
+                    articles[out] = articles[i];
+                }
+                else
+                {
+                    j--;
+                    keys[out] = added[j]->DateKey;
+                    articles[out] = added[j];
+                }
+            }
+        }
+
+        //Articles dated in [fromKey, toKey], in date order. O(log n + k).
+        vector<Article<string>*> articlesBetween(int fromKey, int toKey) const
+        {
+            check_articles();
+            Range found = range(fromKey, toKey);
+            vector<Article<string>*> result;
+            result.reserve(found.size());
+            for (size_t position = found.begin; position < found.end; position++)
+            {
+                result.push_back(article(position));
+            }
+            return result;
+        }
+
+        //Table rows dated in [fromKey, toKey], in date order. O(log n + k).
+        vector<RowId> rowsBetween(int fromKey, int toKey) const
+        {
+            Range found = range(fromKey, toKey);
+            vector<RowId> result;
+            result.reserve(found.size());
+            for (size_t position = found.begin; position < found.end; position++)
+            {
+                result.push_back(row(position));
+            }
+            return result;
+        }
+
+        size_t getSize() const
+        {
+            return keys.size();
+        }
+
+        //True when the source was already in date order (positions and rows coincide).
+        bool inSourceOrder() const
+        {
+            return rows.empty();
+        }
+
+        size_t memoryUsage() const
+        {
+            return keys.capacity() * sizeof(int32_t) + rows.capacity() * sizeof(RowId) + articles.capacity() * sizeof(Article<string>*);
+        }
+
+        void clear()
+        {
+            keys.clear();
+            rows.clear();
+            articles.clear();
+        }
+
+    private:
+        vector<int32_t> keys;              // By position, ascending
+        vector<RowId> rows;                // By position; empty when the source was sorted (row == position)
+        vector<Article<string>*> articles; // By row (list builds only)
+
+        // Put keys into date order. For a sorted source this is only the check.
+        void order_rows()
+        {
+            if (is_sorted(keys.begin(), keys.end())) return;
+            rows.resize(keys.size());
+            iota(rows.begin(), rows.end(), 0);
+            stable_sort(rows.begin(), rows.end(), [&](RowId a, RowId b) { return keys[a] < keys[b]; });
+            vector<int32_t> sorted(keys.size());
+            for (size_t position = 0; position < rows.size(); position++)
+            {
+                sorted[position] = keys[rows[position]];
+            }
+            keys.swap(sorted);
+        }
+
+        void check_articles() const
+        {
+            if (!hasArticles())
+            {
+                throw logic_error("DateIndex was built from a table and has no article pointers.");
+            }
+        }
+
+        static void check_row_count(size_t rows)
+        {
+            if (rows > UINT32_MAX)
+            {
+                throw length_error("DateIndex supports at most 2^32 rows.");
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//Class of a Label value; LABEL_ANY is only used in filters.
+enum ArticleLabel { LABEL_OTHER, LABEL_TRUE, LABEL_FAKE, LABEL_ANY };
+
+//Class of a Category value. "politics" and "politicsNews" are both political; any category mentioning
+//"government" is government news.
+enum CategoryClass { CATEGORY_OTHER, CATEGORY_POLITICAL, CATEGORY_GOVERNMENT };
+
+//Interns the few distinct values of a short column (Category, Label) as 16-bit codes. Values are compared
+//with case and whitespace removed, so "Politics " and "politics" share a code; the spelling seen first is
+//kept for display. Every code also carries a class chosen by the dictionary's classifier, which is how alias
+//groups such as politics/politicsNews are expressed.
+//intern() may be called from several threads (the parallel import does); each thread keeps a small cache of
+//raw values it has already seen, so the shared table is only locked for new spellings. Lookups (text,
+//classOf, find) must not race with interning values that are not in the dictionary yet.
+class FieldDictionary
+{
+    public:
+        typedef uint16_t Code;
+        typedef int (*Classifier)(const string& normalized);
+
+        static const Code NOT_FOUND = UINT16_MAX;
+
+        explicit FieldDictionary(Classifier classifier) : classifier(classifier)
+        {
+            intern(""); //Code 0 is the empty value, the default of a default-constructed article.
+        }
+
+        FieldDictionary(const FieldDictionary&) = delete;
+        FieldDictionary& operator=(const FieldDictionary&) = delete;
+
+        Code intern(string_view value)
+        {
+            for (const CacheEntry& entry : threadCache())
+            {
+                if (entry.owner == this && entry.raw == value) return entry.code;
+            }
+
+            string key = normalize(value);
+            Code code;
+            {
+                lock_guard<mutex> guard(lock);
+                auto found = codes.find(key);
+                if (found != codes.end())
+                {
+                    code = found->second;
+                }
+                else
+                {
+                    if (texts.size() >= NOT_FOUND)
+                    {
+                        throw length_error("FieldDictionary supports at most 65535 distinct values.");
+                    }
+                    code = static_cast<Code>(texts.size());
+                    texts.emplace_back(value);
+                    classes.push_back(classifier(key));
+                    codes.emplace(move(key), code);
+                }
+            }
+
+            vector<CacheEntry>& cache = threadCache();
+            if (cache.size() < MAX_CACHED)
+            {
+                cache.push_back({ this, string(value), code });
+            }
+            return code;
+        }
+
+        //Code of a value, or NOT_FOUND if it was never interned.
+        Code find(string_view value) const
+        {
+            lock_guard<mutex> guard(lock);
+            auto found = codes.find(normalize(value));
+            return found == codes.end() ? NOT_FOUND : found->second;
+        }
+
+        const string& text(Code code) const
+        {
+            return texts[code];
+        }
+
+        int classOf(Code code) const
+        {
+            return classes[code];
+        }
+
+        //Number of codes, including the empty value.
+        size_t size() const
+        {
+            lock_guard<mutex> guard(lock);
+            return texts.size();
+        }
+
+        //Lowercase with all whitespace removed.
+        static string normalize(string_view value)
+        {
+            string key;
+            key.reserve(value.size());
+            for (char c : value)
+            {
+                if (isspace(static_cast<unsigned char>(c))) continue;
+                key.push_back(static_cast<char>(tolower(static_cast<unsigned char>(c))));
+            }
+            return key;
+        }
+
+    private:
+        static const size_t MAX_CACHED = 64;
+
+        struct CacheEntry
+        {
+            const FieldDictionary* owner;
+            string raw;
+            Code code;
+        };
+
+        Classifier classifier;
+        mutable mutex lock;
+        unordered_map<string, Code> codes;
+        deque<string> texts;
+        vector<int> classes;
+
+        static vector<CacheEntry>& threadCache()
+        {
+            static thread_local vector<CacheEntry> cache;
+            return cache;
+        }
+};
+
+int classify_category(const string& normalized)
+{
+    if (normalized == "politics" || normalized == "politicsnews") return CATEGORY_POLITICAL;
+    if (normalized.find("government") != string::npos) return CATEGORY_GOVERNMENT;
+    return CATEGORY_OTHER;
+}
+
+int classify_label(const string& normalized)
+{
+    if (normalized == "true") return LABEL_TRUE;
+    if (normalized == "fake") return LABEL_FAKE;
+    return LABEL_OTHER;
+}
+
+FieldDictionary& category_dictionary()
+{
+    static FieldDictionary dictionary(classify_category);
+    return dictionary;
+}
+
+FieldDictionary& label_dictionary()
+{
+    static FieldDictionary dictionary(classify_label);
+    return dictionary;
+}
+
+#endif
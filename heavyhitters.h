@@ -0,0 +1,362 @@
+#ifndef HEAVYHITTERS_H
+#define HEAVYHITTERS_H
+
+#include "linkedlist.h"
+#include "dictionary.h"
+#include "analytics.h"
+#include "tokenizer.h"
+#include "wordcounter.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//One key reported by SpaceSaving. The true count lies in [count - error, count].
+struct HeavyHitter
+{
+    string_view key;
+    uint64_t count;
+    uint64_t error;
+    bool guaranteed; //Certainly among the true top k: lowerBound() is at least every other key's count.
+
+    uint64_t lowerBound() const
+    {
+        return count - error;
+    }
+};
+
+//Space-Saving heavy hitters: approximate counts of the most frequent keys of a stream in memory fixed at
+//construction. At most capacity keys are monitored; a key that is not monitored replaces the one with the smallest
+//count and inherits that count as its error. Every key whose true count exceeds totalCount() / capacity is
+//monitored, and no count is off by more than maxError() (itself at most totalCount() / capacity).
+//Keys live in a preallocated arena of capacity slots of keyBytes each; longer keys are not counted (see
+//oversizedCount()). The counters sit in an indexed min-heap and an open-addressing table (linear probing with
+//backward-shift deletion), so adding a key is O(1) expected plus O(log capacity) to restore the heap.
+class SpaceSaving
+{
+    public:
+        explicit SpaceSaving(size_t capacity, size_t keyBytes = 64) : keyBytes(keyBytes)
+        {
+            if (capacity == 0 || keyBytes == 0)
+            {
+                throw invalid_argument("SpaceSaving needs a non-zero capacity and key size.");
+            }
+            if (capacity >= EMPTY / 2)
+            {
+                throw length_error("SpaceSaving supports fewer than 2^31 counters.");
+            }
+            size_t slots = 16;
+            while (slots < capacity * 2) slots *= 2;
+            table.assign(slots, EMPTY);
+            counters.resize(capacity);
+            arena.resize(capacity * keyBytes);
+            heap.reserve(capacity);
+            position.resize(capacity);
+        }
+
+        void add(string_view key)
+        {
+            add(key, WordCounter::hash(key));
+        }
+
+        //Add a key whose hash (WordCounter::hash) the caller already computed.
+        void add(string_view key, uint64_t keyHash)
+        {
+            if (key.size() > keyBytes)
+            {
+                oversized++;
+                return;
+            }
+            total++;
+            size_t mask = table.size() - 1;
+            size_t slot = keyHash & mask;
+            for (; table[slot] != EMPTY; slot = (slot + 1) & mask)
+            {
+                uint32_t id = table[slot];
+                if (counters[id].hash == keyHash && keyOf(id) == key)
+                {
+                    counters[id].count++;
+                    siftDown(position[id]);
+                    return;
+                }
+            }
+
+            uint32_t id;
+            uint64_t floor = 0;
+            if (heap.size() < counters.size())
+            {
+                id = static_cast<uint32_t>(heap.size());
+                heap.push_back(id);
+                position[id] = id;
+            }
+            else
+            {
+                // Evict the smallest counter. Deleting its table entry may shift the probe run, so probe again.
+                id = heap[0];
+                floor = counters[id].count;
+                eraseFromTable(id);
+                for (slot = keyHash & mask; table[slot] != EMPTY; slot = (slot + 1) & mask) {}
+            }
+            Counter& counter = counters[id];
+            counter.hash = keyHash;
+            counter.count = floor + 1;
+            counter.error = floor;
+            counter.length = static_cast<uint32_t>(key.size());
+            copy(key.begin(), key.end(), arena.begin() + id * keyBytes);
+            table[slot] = id;
+            siftUp(position[id]);
+            siftDown(position[id]);
+        }
+
+        //The k monitored keys with the highest counts, highest first (ties in key order). The views point into the
+        //counter and stay valid until the next add().
+        vector<HeavyHitter> topK(size_t k) const
+        {
+            vector<HeavyHitter> result;
+            result.reserve(heap.size());
+            for (uint32_t id : heap)
+            {
+                result.push_back({ keyOf(id), counters[id].count, counters[id].error, false });
+            }
+            size_t ranked = min(k + 1, result.size());
+            partial_sort(result.begin(), result.begin() + ranked, result.end(), [](const HeavyHitter& a, const HeavyHitter& b)
+            {
+                return a.count != b.count ? a.count > b.count : a.key < b.key;
+            });
+            // A key outside the reported k has at most the (k + 1)-th count (unmonitored keys at most maxError(),
+            // which is no larger).
+            uint64_t outside = ranked > k ? result[k].count : 0;
+            result.resize(min(k, result.size()));
+            for (HeavyHitter& hitter : result)
+            {
+                hitter.guaranteed = hitter.lowerBound() >= outside;
+            }
+            return result;
+        }
+
+        //Largest possible overcount of any key, and the most a key that is not monitored can have occurred.
+        //0 until the counters fill up, when all counts are exact.
+        uint64_t maxError() const
+        {
+            return heap.size() < counters.size() ? 0 : counters[heap[0]].count;
+        }
+
+        //Keys added, counting repeats (oversized keys excluded).
+        uint64_t totalCount() const
+        {
+            return total;
+        }
+
+        //Keys skipped for being longer than keyBytes.
+        uint64_t oversizedCount() const
+        {
+            return oversized;
+        }
+
+        size_t capacity() const
+        {
+            return counters.size();
+        }
+
+        //Number of keys monitored.
+        size_t size() const
+        {
+            return heap.size();
+        }
+
+        //Bytes held; fixed by the capacity and key size.
+        size_t memoryUsage() const
+        {
+            return arena.capacity() + counters.capacity() * sizeof(Counter)
+                 + (table.capacity() + heap.capacity() + position.capacity()) * sizeof(uint32_t);
+        }
+
+        void clear()
+        {
+            fill(table.begin(), table.end(), EMPTY);
+            heap.clear();
+            total = 0;
+            oversized = 0;
+        }
+
+    private:
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        struct Counter
+        {
+            uint64_t hash = 0;
+            uint64_t count = 0;
+            uint64_t error = 0;
+            uint32_t length = 0;
+        };
+
+        size_t keyBytes;
+        vector<char> arena;         // Counter id * keyBytes -> key bytes
+        vector<Counter> counters;   // By counter id
+        vector<uint32_t> table;     // Hash slot -> counter id, or EMPTY
+        vector<uint32_t> heap;      // Min-heap of counter ids by count
+        vector<uint32_t> position;  // Counter id -> index in heap
+        uint64_t total = 0;
+        uint64_t oversized = 0;
+
+        string_view keyOf(uint32_t id) const
+        {
+            return string_view(arena.data() + id * keyBytes, counters[id].length);
+        }
+
+        void eraseFromTable(uint32_t id)
+        {
+            size_t mask = table.size() - 1;
+            size_t hole = counters[id].hash & mask;
+            while (table[hole] != id) hole = (hole + 1) & mask;
+            // Move back every later entry of the run whose home slot is not between the hole and itself.
+            for (size_t next = (hole + 1) & mask; table[next] != EMPTY; next = (next + 1) & mask)
+            {
+                size_t home = counters[table[next]].hash & mask;
+                if (((next - home) & mask) >= ((next - hole) & mask))
+                {
+                    table[hole] = table[next];
+                    hole = next;
+                }
+            }
+            table[hole] = EMPTY;
+        }
+
+        void swapHeap(size_t a, size_t b)
+        {
+            swap(heap[a], heap[b]);
+            position[heap[a]] = static_cast<uint32_t>(a);
+            position[heap[b]] = static_cast<uint32_t>(b);
+        }
+
+        void siftUp(size_t i)
+        {
+            while (i > 0)
+            {
+                size_t parent = (i - 1) / 2;
+                if (counters[heap[parent]].count <= counters[heap[i]].count) return;
+                swapHeap(i, parent);
+                i = parent;
+            }
+        }
+
+        void siftDown(size_t i)
+        {
+            while (true)
+            {
+                size_t smallest = i;
+                size_t left = 2 * i + 1, right = left + 1;
+                if (left < heap.size() && counters[heap[left]].count < counters[heap[smallest]].count) smallest = left;
+                if (right < heap.size() && counters[heap[right]].count < counters[heap[smallest]].count) smallest = right;
+                if (smallest == i) return;
+                swapHeap(i, smallest);
+                i = smallest;
+            }
+        }
+};
+
+//Streaming top words (n = 1) or n-grams of Content over the articles that pass an AnalyticsFilter, counted with
+//SpaceSaving in fixed memory. N-grams are runs of n consecutive words that contain no stop word, joined by one
+//space ("white house"); stop words are dropped from single-word counts too.
+class NgramHeavyHitters
+{
+    public:
+        NgramHeavyHitters(size_t n, size_t capacity, const AnalyticsFilter& filter = AnalyticsFilter(), size_t keyBytes = 64)
+            : n(n), filter(filter), counter(capacity, keyBytes), tokenizer(false)
+        {
+            if (n == 0)
+            {
+                throw invalid_argument("NgramHeavyHitters needs n >= 1.");
+            }
+            this->filter.category = FieldDictionary::normalize(filter.category);
+            window.resize(n);
+            resolveCategory();
+        }
+
+        //Count the n-grams of every article of a list (or UnrolledList) that passes the filter.
+        template <typename List>
+        void addAll(const List& list)
+        {
+            resolveCategory();
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                add(*node);
+            }
+        }
+
+        //Count the n-grams of one article if it passes the filter.
+        void add(const Article<string>& article)
+        {
+            int categoryClass = category_dictionary().classOf(article.CategoryCode);
+            int label = label_dictionary().classOf(article.LabelCode);
+            if (!AnalyticsEngine::passes(filter, categoryFilter, date_year(article.DateKey), date_month(article.DateKey),
+                                         article.CategoryCode, categoryClass, label))
+            {
+                return;
+            }
+            articles++;
+            size_t run = 0; // Words since the last stop word, capped at n
+            tokenizer.forEachWord(article.Content, [&](string_view word)
+            {
+                if (is_stop_word(word))
+                {
+                    run = 0;
+                    return;
+                }
+                for (size_t i = 0; i + 1 < n; i++) window[i] = window[i + 1];
+                window[n - 1] = word;
+                if (run < n) run++;
+                if (run < n) return;
+                if (n == 1)
+                {
+                    counter.add(word);
+                    return;
+                }
+                key.clear();
+                for (size_t i = 0; i < n; i++)
+                {
+                    if (i > 0) key.push_back(' ');
+                    key.append(window[i]);
+                }
+                counter.add(key);
+            });
+        }
+
+        vector<HeavyHitter> topK(size_t k) const
+        {
+            return counter.topK(k);
+        }
+
+        const SpaceSaving& counts() const
+        {
+            return counter;
+        }
+
+        //Articles that passed the filter.
+        uint64_t articleCount() const
+        {
+            return articles;
+        }
+
+    private:
+        size_t n;
+        AnalyticsFilter filter;
+        int categoryFilter = -1;
+        SpaceSaving counter;
+        WordTokenizer tokenizer;
+        vector<string_view> window; // Last n words, views into the tokenizer's buffer
+        string key;                 // Reused n-gram buffer
+        uint64_t articles = 0;
+
+        // Category values interned after construction are found too.
+        void resolveCategory()
+        {
+            categoryFilter = filter.category.empty() ? -1 : category_dictionary().find(filter.category);
+        }
+};
+
+#endif
@@ -0,0 +1,233 @@
+#ifndef INVERTEDINDEX_H
+#define INVERTEDINDEX_H
+
+#include "linkedlist.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//Inverted index over article Content: token -> posting list of row ids. Rows are numbered in the order
+//articles are added, and each posting list is stored delta + varint encoded, so a query only decodes the
+//postings of its own tokens. Tokens are lowercased runs of letters and digits (bytes >= 0x80 are kept, so
+//UTF-8 words stay whole).
+class InvertedIndex
+{
+    public:
+        typedef uint32_t RowId;
+
+        //Rebuild the index from a list; row ids follow list order.
+        void build(const LinkedList<string>& list)
+        {
+            clear();
+            rows.reserve(list.getSize());
+            for (Article<string>* node = list.getHead(); node; node = node->next)
+            {
+                add(node);
+            }
+        }
+
+        //Index one more article under the next row id.
+        RowId add(Article<string>* article)
+        {
+            if (rows.size() >= UINT32_MAX)
+            {
+                throw length_error("InvertedIndex supports at most 2^32 rows.");
+            }
+            RowId row = static_cast<RowId>(rows.size());
+            rows.push_back(article);
+            forEachToken(article->Content, [&](const string& token)
+            {
+                auto found = tokenIds.find(token);
+                uint32_t id;
+                if (found == tokenIds.end())
+                {
+                    id = static_cast<uint32_t>(postings.size());
+                    tokenIds.emplace(token, id);
+                    postings.emplace_back();
+                }
+                else
+                {
+                    id = found->second;
+                }
+                postings[id].append(row);
+            });
+            return row;
+        }
+
+        Article<string>* article(RowId row) const
+        {
+            return rows[row];
+        }
+
+        size_t getSize() const
+        {
+            return rows.size();
+        }
+
+        //Number of distinct tokens.
+        size_t tokenCount() const
+        {
+            return postings.size();
+        }
+
+        //Rows containing word, normalized the same way as Content. Input that splits into several tokens
+        //("white house") needs every one of them, as in searchAll.
+        vector<RowId> lookup(const string& word) const
+        {
+            return searchAll(vector<string>(1, word));
+        }
+
+        //Rows containing every token of every keyword (a keyword with several words needs all of them).
+        vector<RowId> searchAll(const vector<string>& keywords) const
+        {
+            vector<const PostingList*> lists;
+            for (const string& keyword : keywords)
+            {
+                forEachToken(keyword, [&](const string& token) { lists.push_back(findToken(token)); });
+            }
+            vector<RowId> result;
+            if (lists.empty() || find(lists.begin(), lists.end(), nullptr) != lists.end())
+            {
+                return result;
+            }
+
+            // Start from the shortest list so the running intersection stays small.
+            sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b) { return a->count < b->count; });
+            lists[0]->decode(result);
+            vector<RowId> next, merged;
+            for (size_t i = 1; i < lists.size() && !result.empty(); i++)
+            {
+                next.clear();
+                lists[i]->decode(next);
+                merged.clear();
+                set_intersection(result.begin(), result.end(), next.begin(), next.end(), back_inserter(merged));
+                result.swap(merged);
+            }
+            return result;
+        }
+
+        //Rows containing any of the keywords (all words of a multi-word keyword must be present).
+        vector<RowId> searchAny(const vector<string>& keywords) const
+        {
+            vector<RowId> result, part, merged;
+            for (const string& keyword : keywords)
+            {
+                part = searchAll(vector<string>(1, keyword));
+                merged.clear();
+                set_union(result.begin(), result.end(), part.begin(), part.end(), back_inserter(merged));
+                result.swap(merged);
+            }
+            return result;
+        }
+
+        //Bytes held by the posting lists, the token table and the row table.
+        size_t memoryUsage() const
+        {
+            size_t bytes = rows.capacity() * sizeof(Article<string>*) + postings.capacity() * sizeof(PostingList);
+            for (const PostingList& list : postings)
+            {
+                bytes += list.bytes.capacity();
+            }
+            for (const auto& entry : tokenIds)
+            {
+                bytes += sizeof(entry) + entry.first.capacity();
+            }
+            return bytes;
+        }
+
+        void clear()
+        {
+            rows.clear();
+            postings.clear();
+            tokenIds.clear();
+        }
+
+        //Call f with each lowercase token of text, in order. The token buffer is reused between calls.
+        template <typename F>
+        static void forEachToken(string_view text, F f)
+        {
+            string token;
+            size_t i = 0;
+            while (i < text.size())
+            {
+                while (i < text.size() && !isTokenChar(text[i])) i++;
+                token.clear();
+                while (i < text.size() && isTokenChar(text[i]))
+                {
+                    char c = text[i++];
+                    token.push_back((c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c);
+                }
+                if (!token.empty())
+                {
+                    f(token);
+                }
+            }
+        }
+
+    private:
+        struct PostingList
+        {
+            vector<uint8_t> bytes;
+            RowId last = 0;
+            uint32_t count = 0;
+
+            void append(RowId row)
+            {
+                if (count > 0 && row == last) return; //Token repeated within the same article.
+                uint32_t delta = (count == 0) ? row : row - last;
+                while (delta >= 0x80)
+                {
+                    bytes.push_back(static_cast<uint8_t>(delta | 0x80));
+                    delta >>= 7;
+                }
+                bytes.push_back(static_cast<uint8_t>(delta));
+                last = row;
+                count++;
+            }
+
+            void decode(vector<RowId>& out) const
+            {
+                out.reserve(out.size() + count);
+                RowId row = 0;
+                size_t i = 0;
+                while (i < bytes.size())
+                {
+                    uint32_t delta = 0;
+                    int shift = 0;
+                    uint8_t b;
+                    do
+                    {
+                        b = bytes[i++];
+                        delta |= static_cast<uint32_t>(b & 0x7F) << shift;
+                        shift += 7;
+                    } while (b & 0x80);
+                    row += delta;
+                    out.push_back(row);
+                }
+            }
+        };
+
+        vector<Article<string>*> rows;
+        vector<PostingList> postings;
+        unordered_map<string, uint32_t> tokenIds;
+
+        static bool isTokenChar(char c)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+            return (u >= '0' && u <= '9') || ((u | 0x20) >= 'a' && (u | 0x20) <= 'z') || u >= 0x80;
+        }
+
+        const PostingList* findToken(const string& token) const
+        {
+            auto found = tokenIds.find(token);
+            return found == tokenIds.end() ? nullptr : &postings[found->second];
+        }
+};
+
+#endif
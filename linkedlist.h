@@ -3,12 +3,33 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <new>
+#include "profiler.h"
+#include "dictionary.h"
 
 using namespace std;
 
+//Dictionary code of a field value; only text fields are interned.
+template <typename T>
+FieldDictionary::Code intern_field(FieldDictionary& dictionary, const T& value)
+{
+    if constexpr (is_convertible<const T&, string_view>::value)
+    {
+        return dictionary.intern(value);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 template <typename T>
 struct Article
 {
@@ -17,20 +38,195 @@ struct Article
     T Category;
     T Date;
     T Label;
+    int DateKey = 0; //Packed yyyymmdd date, parsed once at import.
+    uint16_t CategoryCode = 0; //Category and Label interned in category_dictionary() / label_dictionary().
+    uint16_t LabelCode = 0;
     Article* next;
 
     Article() = default;
-    Article(T t, T con, T cat, T d, T l)
-        :Title(t), Content(con), Category(cat), Date(d), Label(l), next(nullptr){}
+    //Fields are built in place from whatever is passed: rvalues are moved in, string_views are copied once.
+    //The codes are interned from the stored fields, since the arguments may have been moved from.
+    template <typename TitleArg, typename ContentArg, typename CategoryArg, typename DateArg, typename LabelArg>
+    Article(TitleArg&& t, ContentArg&& con, CategoryArg&& cat, DateArg&& d, LabelArg&& l, int key = 0)
+        :Title(forward<TitleArg>(t)), Content(forward<ContentArg>(con)), Category(forward<CategoryArg>(cat)),
+         Date(forward<DateArg>(d)), Label(forward<LabelArg>(l)), DateKey(key),
+         CategoryCode(intern_field(category_dictionary(), Category)), LabelCode(intern_field(label_dictionary(), Label)), next(nullptr){}
 };
 
+// Packed date key helpers: keys are stored as yyyymmdd.
+int date_year(int key) { return key / 10000; }
+int date_month(int key) { return (key / 100) % 100; }
+int date_day(int key) { return key % 100; }
+
+//Node allocator policy that gives every article its own new/delete.
 template <typename T>
+class HeapNodeAllocator
+{
+    public:
+        template <typename... Args>
+        Article<T>* create(Args&&... args)
+        {
+            allocations++;
+            return new Article<T>(forward<Args>(args)...);
+        }
+
+        void destroy(Article<T>* node)
+        {
+            delete node;
+        }
+
+        //Free every node of a chain, one delete per node.
+        void destroy_all(Article<T>* head)
+        {
+            while (head != nullptr)
+            {
+                Article<T>* next = head -> next;
+                delete head;
+                head = next;
+            }
+        }
+
+        //Take over the nodes of another allocator (nothing to do: every node is freed on its own).
+        void adopt(HeapNodeAllocator&) {}
+
+        //Number of calls made to the system allocator for nodes.
+        size_t allocationCount() const
+        {
+            return allocations;
+        }
+
+    private:
+        size_t allocations = 0;
+};
+
+//Node allocator policy that hands out articles from blocks of BlockSize nodes. Single nodes freed by
+//popfront/erase go on a free list for reuse; destroy_all releases whole blocks without freeing node by node,
+//and skips walking the chain entirely when Article<T> is trivially destructible. Article<string> is not: its
+//strings must be destroyed, so clear() still visits every node and is O(n), only without the per-node free.
+template <typename T, size_t BlockSize = 4096>
+class PoolNodeAllocator
+{
+    public:
+        PoolNodeAllocator() = default;
+        PoolNodeAllocator(const PoolNodeAllocator&) = delete;
+        PoolNodeAllocator& operator=(const PoolNodeAllocator&) = delete;
+
+        ~PoolNodeAllocator()
+        {
+            release_blocks();
+        }
+
+        template <typename... Args>
+        Article<T>* create(Args&&... args)
+        {
+            void* slot;
+            if (freeList != nullptr)
+            {
+                slot = freeList;
+                freeList = freeList -> next;
+            }
+            else
+            {
+                if (blocks.empty() || used == BlockSize)
+                {
+                    blocks.push_back(static_cast<Slot*>(::operator new(sizeof(Slot) * BlockSize)));
+                    used = 0;
+                }
+                slot = &blocks.back()[used++];
+            }
+            return new (slot) Article<T>(forward<Args>(args)...);
+        }
+
+        void destroy(Article<T>* node)
+        {
+            node -> ~Article<T>();
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(node);
+            slot -> next = freeList;
+            freeList = slot;
+        }
+
+        void destroy_all(Article<T>* head)
+        {
+            if (!is_trivially_destructible<Article<T>>::value)
+            {
+                while (head != nullptr)
+                {
+                    Article<T>* next = head -> next;
+                    head -> ~Article<T>();
+                    head = next;
+                }
+            }
+            release_blocks();
+        }
+
+        //Take over the blocks of another pool, e.g. when its nodes are spliced into this list.
+        //Its free slots and the unused tail of its current block are not reused, only released with the blocks.
+        void adopt(PoolNodeAllocator& other)
+        {
+            if (other.blocks.empty())
+            {
+                return;
+            }
+            //Keep this pool's partially used block last so allocation continues in it.
+            Slot* current = blocks.empty() ? nullptr : blocks.back();
+            if (current != nullptr)
+            {
+                blocks.pop_back();
+            }
+            blocks.insert(blocks.end(), other.blocks.begin(), other.blocks.end());
+            if (current != nullptr)
+            {
+                blocks.push_back(current);
+            }
+            else
+            {
+                used = BlockSize;
+            }
+            allocations += other.allocations;
+            other.blocks.clear();
+            other.freeList = nullptr;
+            other.used = 0;
+        }
+
+        size_t allocationCount() const
+        {
+            return allocations + blocks.size();
+        }
+
+    private:
+        union FreeSlot
+        {
+            FreeSlot* next;
+            alignas(Article<T>) unsigned char storage[sizeof(Article<T>)];
+        };
+        typedef FreeSlot Slot;
+
+        vector<Slot*> blocks;
+        size_t used = 0;
+        FreeSlot* freeList = nullptr;
+        size_t allocations = 0; //Blocks already released or adopted.
+
+        void release_blocks()
+        {
+            allocations += blocks.size();
+            for (Slot* block : blocks)
+            {
+                ::operator delete(block);
+            }
+            blocks.clear();
+            used = 0;
+            freeList = nullptr;
+        }
+};
+
+template <typename T, typename Allocator = PoolNodeAllocator<T>>
 class LinkedList
 {
     private:
         Article<T>* head;
         Article<T>* tail;  
         size_t size;  
+        Allocator allocator;
 
     public:
         class Iterator 
@@ -70,19 +266,27 @@ class LinkedList
         };
         
         LinkedList() : head(nullptr), tail(nullptr), size(0) {}
+        LinkedList(const LinkedList&) = delete;
+        LinkedList& operator=(const LinkedList&) = delete;
 
         ~LinkedList()
         {
-            while (head != nullptr)
-            {
-                popfront();
-            }
+            allocator.destroy_all(head);
         }
 
         //Adding acticles to the linkedlist tail，for adding new articles data continuously.
-        void pushback(T Title, T Content, T Category, T Date, T Label)
+        void pushback(T Title, T Content, T Category, T Date, T Label, int DateKey = 0)
         {
-            Article<T>* newArticle = new Article<T>(Title, Content, Category, Date, Label);
+            emplace_back(move(Title), move(Content), move(Category), move(Date), move(Label), DateKey);
+        }
+
+        //Build an article in place at the tail from the Article constructor's arguments (e.g. moved strings or
+        //string_views into a parsed buffer), so no field is copied more than once.
+        template <typename... Args>
+        Article<T>* emplace_back(Args&&... args)
+        {
+            Article<T>* newArticle = allocator.create(forward<Args>(args)...);
+            PROFILE_COUNT(COUNTER_NODES_ALLOCATED);
             //If the list is empty, the new articles become head and tail. 
             if (head == nullptr)
             {
@@ -95,6 +299,7 @@ class LinkedList
                 tail = newArticle;
             }
             size++;
+            return newArticle;
         }
 
         //Remove first article from the list.
@@ -110,7 +315,7 @@ class LinkedList
             {
                 tail = nullptr;
             }
-            delete temp;
+            allocator.destroy(temp);
             size--;
         }
         
@@ -149,37 +354,40 @@ class LinkedList
         }
 
         //Insert the specific data to the specific(random) place.
-        void insert(size_t index, T Title, T Content, T Category, T Date, T Label)
+        void insert(size_t index, T Title, T Content, T Category, T Date, T Label, int DateKey = 0)
+        {
+            emplace(index, move(Title), move(Content), move(Category), move(Date), move(Label), DateKey);
+        }
+
+        //Build an article in place before position index (index == size appends), like emplace_back.
+        template <typename... Args>
+        Article<T>* emplace(size_t index, Args&&... args)
         {
             if(index > size)
             {
                 throw out_of_range("Index out of range.");
             }
 
+            if(index == size)
+            {
+                return emplace_back(forward<Args>(args)...);
+            }
+
+            Article<T>* newArticle = allocator.create(forward<Args>(args)...);
+            PROFILE_COUNT(COUNTER_NODES_ALLOCATED);
             if (index == 0)
             {
-               Article<T>* newArticles = new Article<T>(Title, Content, Category, Date, Label);
-               newArticles -> next = head;
-               head = newArticles;
-
-               if(tail == nullptr)
-               {
-                   tail = newArticles;
-               }
-           }
-           else if(index == size)
-           {
-               pushback(Title, Content, Category, Date, Label);
-               return;
-           }
-           else
-           {
-               Article<T>* prev = get(index - 1);
-               Article<T>* newArticle = new Article<T>(Title, Content, Category, Date, Label);
-               newArticle -> next = prev -> next;
-               prev -> next = newArticle;
-           }
+                newArticle -> next = head;
+                head = newArticle;
+            }
+            else
+            {
+                Article<T>* prev = get(index - 1);
+                newArticle -> next = prev -> next;
+                prev -> next = newArticle;
+            }
             size++;
+            return newArticle;
         }
 
         //Erase the articles at a specific index.
@@ -199,7 +407,7 @@ class LinkedList
                 Article<T>* prev = get(index - 1);
                 Article<T>* to_delete = prev -> next;
                 prev -> next = to_delete -> next;
-                delete to_delete;
+                allocator.destroy(to_delete);
                 size--;
 
                 //If the last node was deleted updated the tail.
@@ -210,22 +418,112 @@ class LinkedList
             }
         }
 
+        //Move every article of other to the end of this list in O(1); other is left empty.
+        void splice_back(LinkedList& other)
+        {
+            if (other.head == nullptr)
+            {
+                return;
+            }
+            if (head == nullptr)
+            {
+                head = other.head;
+            }
+            else
+            {
+                tail -> next = other.head;
+            }
+            tail = other.tail;
+            size += other.size;
+            allocator.adopt(other.allocator);
+            other.head = other.tail = nullptr;
+            other.size = 0;
+        }
+
+        //Merge other into this list, both in DateKey order, and leave other empty. Among equal dates the nodes
+        //already in this list come first, so the result is what appending other and sorting stably would give.
+        //Runs of other that fall between two nodes are linked in as a whole. If start is given it must be a node
+        //of this list with DateKey <= every key of other (found e.g. through a date index); merging begins after
+        //it, so the nodes before it are never visited. A batch newer than the whole list is just appended.
+        void merge_sorted(LinkedList& other, Article<T>* start = nullptr)
+        {
+            if (other.head == nullptr)
+            {
+                return;
+            }
+            if (start != nullptr && start -> DateKey > other.head -> DateKey)
+            {
+                throw invalid_argument("merge_sorted: start is later than the first merged article.");
+            }
+            if (head == nullptr || tail -> DateKey <= other.head -> DateKey)
+            {
+                splice_back(other);
+                return;
+            }
+
+            Article<T>* prev = start;
+            Article<T>* current = start ? start -> next : head;
+            Article<T>* incoming = other.head;
+            while (incoming != nullptr)
+            {
+                if (current == nullptr)
+                {
+                    prev -> next = incoming;
+                    tail = other.tail;
+                    break;
+                }
+                if (incoming -> DateKey < current -> DateKey)
+                {
+                    Article<T>* runEnd = incoming;
+                    while (runEnd -> next != nullptr && runEnd -> next -> DateKey < current -> DateKey)
+                    {
+                        runEnd = runEnd -> next;
+                    }
+                    Article<T>* nextIncoming = runEnd -> next;
+                    if (prev == nullptr)
+                    {
+                        head = incoming;
+                    }
+                    else
+                    {
+                        prev -> next = incoming;
+                    }
+                    runEnd -> next = current;
+                    prev = runEnd;
+                    incoming = nextIncoming;
+                }
+                else
+                {
+                    prev = current;
+                    current = current -> next;
+                }
+            }
+            size += other.size;
+            allocator.adopt(other.allocator);
+            other.head = other.tail = nullptr;
+            other.size = 0;
+        }
+
         //Get the linkedlists size
         size_t getSize() const
         {
             return size;
         }
 
-        //Clear the linkedlists.
+        //Clear the linkedlists. With the pool allocator the nodes are released block by block.
         void clear()
         {
-            while (head)
-            {
-                popfront();
-            }
+            allocator.destroy_all(head);
+            head = tail = nullptr;
             size = 0;
         }
 
+        //Get the node allocator, e.g. to read its allocation count.
+        const Allocator& getAllocator() const
+        {
+            return allocator;
+        }
+
         //Get the iterator which point to the list head.
         Iterator begin() const
         {
@@ -263,6 +561,11 @@ class LinkedList
         void setHead(Article<T>* newHead) {
             head = newHead;
         } 
+
+        //Set the node's tail, used after the nodes have been relinked (e.g. by sorting).
+        void setTail(Article<T>* newTail) {
+            tail = newTail;
+        }
 };
 
 #endif
\ No newline at end of file
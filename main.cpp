@@ -22,42 +22,106 @@ void printTopFive(Article<string>* head)
     }
 }
 
-//Function for Save timsort output into csv file
-void save_sorted_data_to_csv(LinkedList<string>& newsList, const string& filename) 
+// Start from the binary snapshot of the sorted table instead of importing and sorting the CSV. The snapshot is
+// rebuilt first if it is missing or merge.csv changed since it was written.
+int run_from_snapshot()
 {
-    ofstream outFile(filename);
-
-    if (!outFile.is_open()) 
+    ArticleTable newsTable;
+    bool loaded = false;
+    try
     {
-        cerr << "Error: Could not open file for writing." << endl;
-        return;
+        PhaseTimer phase("snapshot_startup");
+        loaded = load_or_build_snapshot("merge.csv", "news.snapshot", newsTable, thread::hardware_concurrency());
     }
+    catch (const runtime_error& e)
+    {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    cout << (loaded ? "Loaded" : "Rebuilt") << " news.snapshot in " << profiler().find("snapshot_startup")->milliseconds
+         << " ms (" << newsTable.getSize() << " articles)" << endl;
 
-    outFile << "Date,Title,Content,Category,Label\n"; // Writing headers
-
-    Article<string>* current = newsList.getHead();
-    while (current) 
+    AnalyticsEngine report;
+    AnalyticsFilter fakeOnly;
+    fakeOnly.label = LABEL_FAKE;
+    AnalyticsFilter political2016;
+    political2016.year = 2016;
+    political2016.politicalOnly = true;
+    size_t labelCounts = report.addCount("news_by_label", AnalyticsFilter(), GROUP_LABEL);
+    size_t fakePolitical2016 = report.addRatio("fake_political_2016", political2016, fakeOnly);
+    vector<AnalyticsResult> reportResults;
     {
-        outFile << current->Date << ","
-                << "\"" << current->Title << "\","
-                << "\"" << current->Content << "\","
-                << current->Category << ","
-                << current->Label << "\n";
-        current = current->next;
+        PhaseTimer phase("analytics_report");
+        reportResults = report.run(newsTable);
     }
+    for (const AnalyticsGroup& group : reportResults[labelCounts].groups)
+    {
+        cout << "Total " << group.key << " news: " << group.counts.total << endl;
+    }
+    cout << "Fake political news in 2016: " << fixed << setprecision(2) << reportResults[fakePolitical2016].counts.percentage() << "%" << endl;
 
-    outFile.close();
-    cout << "Sorted data saved to " << filename << endl;
+    if (profiler().saveJson("profile_report.json"))
+    {
+        cout << "Profile report saved to profile_report.json" << endl;
+    }
+    return 0;
 }
 
-int main() 
+// Options: --snapshot starts from news.snapshot (see run_from_snapshot); --write-snapshot saves the sorted table
+// to news.snapshot during a normal run. --from-sources reads true.csv and fake.csv directly instead of merge.csv
+// (no DataClean step), and --write-merge also writes merge.csv while doing so. --append FILE merges a batch of
+// new articles into the sorted list and indexes before the report.
+int main(int argc, char* argv[]) 
 {
+    bool writeSnapshot = false;
+    bool fromSources = false;
+    bool writeMerge = false;
+    string appendFile;
+    for (int i = 1; i < argc; i++)
+    {
+        string option = argv[i];
+        if (option == "--snapshot")
+        {
+            return run_from_snapshot();
+        }
+        if (option == "--write-snapshot")
+        {
+            writeSnapshot = true;
+        }
+        else if (option == "--from-sources")
+        {
+            fromSources = true;
+        }
+        else if (option == "--write-merge")
+        {
+            writeMerge = true;
+        }
+        else if (option == "--append" && i + 1 < argc)
+        {
+            appendFile = argv[++i];
+        }
+        else
+        {
+            cerr << "Unknown option: " << option << endl;
+            return 1;
+        }
+    }
+
 //----------------------------------------Linked list and Sorting algorithm----------------------------------------
     LinkedList<string> newsList;
+    vector<ImportReject> rejects;
     // Import data from CSV file
     try 
     {
-        import_csv_to_linkedlist("merge.csv", newsList);
+        PhaseTimer phase("import");
+        if (fromSources)
+        {
+            ingest_sources({ { "true.csv", "True" }, { "fake.csv", "Fake" } }, newsList, rejects, writeMerge ? "merge.csv" : "");
+        }
+        else
+        {
+            import_csv_to_linkedlist("merge.csv", newsList, rejects, thread::hardware_concurrency());
+        }
     } 
     catch (const runtime_error& e) 
     {
@@ -65,35 +129,186 @@ int main()
         return 1;
     }
 
-    
+    //Report the rows that were skipped (unparseable date, or an empty field in a source file).
+    if (!rejects.empty())
+    {
+        cerr << "Skipped " << rejects.size() << " rows during import:" << endl;
+        for (size_t i = 0; i < rejects.size() && i < 10; i++)
+        {
+            cerr << "  row " << rejects[i].row << ": " << rejects[i].reason << " \"" << rejects[i].Date << "\"" << endl;
+        }
+    }
 
-    // Perform Timsort on the linked list
-    TimSort timSorter;
-    Article<string>* head = newsList.getHead();
-    timSorter.timSort(head);
-    newsList.setHead(head); // Update the head pointer after sorting
+    // Sort the linked list by date with a stable bucket pass per calendar day (same order as Timsort).
+    RadixSort sorter;
+    {
+        PhaseTimer phase("sort");
+        sorter.radixSort(newsList); // Updates the list head and tail after sorting
+    }
 
     // ----- Sorting algorithm measurement -----
-    size_t memoryBeforeSort = getCurrentMemoryUsage();
-    auto startSort = high_resolution_clock::now();
-
-    auto endSort = high_resolution_clock::now();
-    size_t memoryAfterSort = getCurrentMemoryUsage();
-
-    double timeTakenSort = duration<double, milli>(endSort - startSort).count();
-    size_t memoryUsedSort = (memoryAfterSort > memoryBeforeSort) ? (memoryAfterSort - memoryBeforeSort) : 0;
+    const PhaseRecord* sortPhase = profiler().find("sort");
+    size_t memoryUsedSort = (sortPhase->rssAfter > sortPhase->rssBefore) ? (sortPhase->rssAfter - sortPhase->rssBefore) : 0;
 
     // Output sorting performance results
-    cout << "Timsort Sorting Time: " << timeTakenSort << " ms" << endl;
-    cout << "Timsort Memory Usage: " << memoryUsedSort / 1024 << " KB" << endl;
+    cout << "Sorting Time: " << sortPhase->milliseconds << " ms" << endl;
+    cout << "Sorting Memory Usage: " << memoryUsedSort / 1024 << " KB" << endl;
     
     //Save the sorted data to a new CSV file
-    save_sorted_data_to_csv(newsList, "sorted_news.csv"); 
+    {
+        PhaseTimer phase("export");
+        save_sorted_data_to_csv(newsList, "sorted_news.csv", thread::hardware_concurrency()); 
+    }
     
     //Testing if the sorting operated correctly.
     cout << "----- Sorted Articles (First 5) -----" << endl;
     printTopFive(newsList.getHead());
 
+//--------------------------------------Inverted index for keyword search-----------------------------------------
+    // Built over the sorted list, so indexed search results come back in date order. Rows added by --append get
+    // the next row ids, so they are listed after the older articles whatever their date.
+    InvertedIndex keywordIndex;
+    {
+        PhaseTimer phase("build_inverted_index");
+        keywordIndex.build(newsList);
+    }
+    cout << "Inverted index build time: " << profiler().find("build_inverted_index")->milliseconds << " ms ("
+         << keywordIndex.tokenCount() << " tokens, " << keywordIndex.memoryUsage() / 1024 << " KB)" << endl;
+
+//--------------------------------------Columnar store vs node-based list------------------------------------------
+    ArticleTable newsTable;
+    {
+        PhaseTimer phase("build_article_table");
+        newsTable = ArticleTable::fromList(newsList);
+    }
+    if (writeSnapshot)
+    {
+        uint64_t sourceBytes = 0;
+        int64_t sourceModified = 0;
+        source_stamp("merge.csv", sourceBytes, sourceModified);
+        try
+        {
+            PhaseTimer phase("snapshot_write");
+            newsTable.saveSnapshot("news.snapshot", sourceBytes, sourceModified);
+            cout << "Snapshot saved to news.snapshot" << endl;
+        }
+        catch (const runtime_error& e)
+        {
+            cerr << "Error: " << e.what() << endl;
+        }
+    }
+    LinearSearch scanner;
+    int listTrue = 0, listFake = 0, tableTrue = 0, tableFake = 0;
+    double listPercentage = 0, tablePercentage = 0;
+
+    // Same two scans (label counts and 2016 political ratio) over each layout.
+    {
+        PhaseTimer phase("scan_linked_list");
+        scanner.countLabels(newsList, listTrue, listFake);
+        listPercentage = scanner.percentageFakePolitical2016(newsList);
+    }
+    {
+        PhaseTimer phase("scan_article_table");
+        scanner.countLabels(newsTable, tableTrue, tableFake);
+        tablePercentage = scanner.percentageFakePolitical2016(newsTable);
+    }
+
+    double listScanTime = profiler().find("scan_linked_list")->milliseconds;
+    double tableScanTime = profiler().find("scan_article_table")->milliseconds;
+    size_t articleCount = newsList.getSize();
+
+    if (articleCount > 0)
+    {
+        cout << "----- Columnar store vs linked list -----" << endl;
+        cout << "Linked list bytes per article: " << list_memory_usage(newsList) / articleCount << endl;
+        cout << "ArticleTable bytes per article: " << newsTable.memoryUsage() / articleCount << endl;
+        cout << "Linked list scan: " << listScanTime << " ms ("
+             << articleCount / max(listScanTime, 1e-6) / 1000 << " M articles/s)" << endl;
+        cout << "ArticleTable scan: " << tableScanTime << " ms ("
+             << articleCount / max(tableScanTime, 1e-6) / 1000 << " M articles/s)" << endl;
+        if (listTrue != tableTrue || listFake != tableFake || listPercentage != tablePercentage)
+        {
+            cerr << "Warning: columnar scan results differ from the linked list." << endl;
+        }
+    }
+
+//----------------------------------------------Date range index-------------------------------------------------
+    // Positions of the sorted list by date, so year and month queries only visit their own range.
+    DateIndex dateIndex;
+    {
+        PhaseTimer phase("build_date_index");
+        dateIndex.build(newsList);
+    }
+    double indexedPercentage = 0;
+    {
+        PhaseTimer phase("query_date_index");
+        indexedPercentage = scanner.percentageFakePolitical2016(dateIndex);
+    }
+    cout << "Date index build time: " << profiler().find("build_date_index")->milliseconds << " ms; 2016 query: "
+         << profiler().find("query_date_index")->milliseconds << " ms (" << dateIndex.yearRange(2016).size() << " of "
+         << dateIndex.getSize() << " articles visited)" << endl;
+    if (indexedPercentage != listPercentage)
+    {
+        cerr << "Warning: date index results differ from the linked list." << endl;
+    }
+
+    // New articles (e.g. a daily batch): sorted on their own and merged in, with both indexes updated in place.
+    if (!appendFile.empty())
+    {
+        size_t added = 0;
+        vector<ImportReject> batchRejects;
+        try
+        {
+            PhaseTimer phase("append_batch");
+            added = append_batch(appendFile, newsList, batchRejects, &dateIndex, &keywordIndex, thread::hardware_concurrency());
+        }
+        catch (const runtime_error& e)
+        {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+        cout << "Appended " << added << " articles from " << appendFile << " in " << profiler().find("append_batch")->milliseconds
+             << " ms (" << newsList.getSize() << " in total)" << endl;
+        if (!batchRejects.empty())
+        {
+            cerr << "Skipped " << batchRejects.size() << " rows of " << appendFile << ":" << endl;
+            for (size_t i = 0; i < batchRejects.size() && i < 10; i++)
+            {
+                cerr << "  row " << batchRejects[i].row << ": " << batchRejects[i].reason << " \"" << batchRejects[i].Date << "\"" << endl;
+            }
+        }
+    }
+
+//-----------------------------------------Nightly report in one pass---------------------------------------------
+    // Menu items 1, 2 and 4 as aggregations over a single traversal.
+    AnalyticsEngine report;
+    AnalyticsFilter fakeOnly;
+    fakeOnly.label = LABEL_FAKE;
+    AnalyticsFilter political2016;
+    political2016.year = 2016;
+    political2016.politicalOnly = true;
+    size_t labelCounts = report.addCount("news_by_label", AnalyticsFilter(), GROUP_LABEL);
+    size_t fakePolitical2016 = report.addRatio("fake_political_2016", political2016, fakeOnly);
+    size_t fakePoliticalByMonth = report.addRatio("fake_political_2016_by_month", political2016, fakeOnly, GROUP_MONTH);
+    vector<AnalyticsResult> reportResults;
+    {
+        PhaseTimer phase("analytics_report");
+        reportResults = report.run(newsList);
+    }
+    cout << "----- Nightly report (" << profiler().find("analytics_report")->milliseconds << " ms, one pass) -----" << endl;
+    for (const AnalyticsGroup& group : reportResults[labelCounts].groups)
+    {
+        cout << "Total " << group.key << " news: " << group.counts.total << endl;
+    }
+    cout << "Fake political news in 2016: " << fixed << setprecision(2) << reportResults[fakePolitical2016].counts.percentage() << "%" << endl;
+    for (const AnalyticsGroup& group : reportResults[fakePoliticalByMonth].groups)
+    {
+        if (group.month == 0) continue;
+        cout << setw(3) << getMonthAbbreviation(group.month) << " | " << setprecision(0) << group.counts.percentage() << "%" << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+
 //-----------------------------------------------------------------------------------------------------------------
 /*    
 //Display the menu for the user's choice
@@ -104,6 +319,8 @@ int main()
     cout << "3. Top 10 frequent words in government fake news." << endl;
     cout << "4. Percentage of fake political news articles for each month in the year 2016." << endl;
     cout << "5. Search articles by insert keywords." << endl;
+    cout << "6. Search articles by a watch list of keywords." << endl;
+    cout << "7. Top words or phrases for a category, label or year." << endl;
     cout << string(60,'-') << endl;
     cout << "Enter your choice: ";
     cin >> choice;
@@ -116,47 +333,70 @@ int main()
     {
         case 1:
             {
-            //Record memory and time usage before searching
-            size_t memoryBeforeSearch = getCurrentMemoryUsage();
-            auto startSearch = high_resolution_clock::now();
-
-            // Total number of news (both fake and true)
-            searcher.countNews(newsList);
-
-            //Record memory and time usage after searching
-            auto endSearch = high_resolution_clock::now();
-            size_t memoryAfterSearch = getCurrentMemoryUsage();
-
-            double timeTakenSearch = duration<double, milli>(endSearch - startSearch).count();
-            size_t memoryUsedSearch = memoryAfterSearch - memoryBeforeSearch;
-
-            cout << "Linear Search Total News Time: " << timeTakenSearch << " ms" << endl;
-            cout << "Linear Search Memory Usage: " << memoryUsedSearch / 1024 << " KB" << endl;
+                {
+                    PhaseTimer phase("query_count_news");
+                    // Total number of news (both fake and true)
+                    searcher.countNews(newsList);
+                }
+                const PhaseRecord* search = profiler().find("query_count_news");
+                long long memoryUsedSearch = static_cast<long long>(search->rssAfter) - static_cast<long long>(search->rssBefore);
+                cout << "Linear Search Total News Time: " << search->milliseconds << " ms" << endl;
+                cout << "Linear Search Memory Usage: " << memoryUsedSearch / 1024 << " KB" << endl;
             }
             break;
         case 2:
             {
+                PhaseTimer phase("query_fake_political_2016");
                 // Percentage of fake political news in 2016
-                double percentage = searcher.percentageFakePolitical2016(newsList);
+                double percentage = searcher.percentageFakePolitical2016(dateIndex);
                 cout << "Percentage of fake political news in 2016: " << percentage << "%" << endl;
             }
             break;
         case 3:
-            // Top 10 frequent words in fake government news
-            searcher.top10FrequentWordsInGovernmentFakeNews(newsList);
+            {
+                PhaseTimer phase("query_top_words_government_fake");
+                // Top 10 frequent words in fake government news
+                searcher.top10FrequentWordsInGovernmentFakeNews(newsList);
+            }
             break;
         case 4:
-            // Percentage of fake political news articles for each month in 2016
-            searcher.percentageFakePoliticalByMonth(newsList);
+            {
+                PhaseTimer phase("query_fake_political_by_month");
+                // Percentage of fake political news articles for each month in 2016
+                searcher.percentageFakePoliticalByMonth(dateIndex);
+            }
             break;
         case 5:
-            // Search articles by inserted keywords
-            searcher.searchArticlesByKeyword(newsList);
+            {
+                PhaseTimer phase("query_keyword_search");
+                // Search articles by inserted keywords through the inverted index
+                searcher.searchArticlesByKeyword(keywordIndex);
+            }
+            break;
+        case 6:
+            {
+                PhaseTimer phase("query_watch_list");
+                // Every keyword of the list in one pass over Content (Aho-Corasick)
+                searcher.searchArticlesByWatchList(newsList);
+            }
+            break;
+        case 7:
+            {
+                PhaseTimer phase("query_top_phrases");
+                // Approximate top words / n-grams in fixed memory (Space-Saving)
+                searcher.searchTopPhrases(newsList);
+            }
             break;
         default:
             cout << "Invalid choice." << endl;
     }    
             */
 
+    //Per-phase time, memory and counters as a machine-readable report.
+    if (profiler().saveJson("profile_report.json"))
+    {
+        cout << "Profile report saved to profile_report.json" << endl;
+    }
+
     return 0; 
 }
@@ -0,0 +1,283 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+using namespace std;
+
+//Hot-path event counters. They compile to nothing unless NEWS_PROFILE_EVENTS is defined, so the sort and
+//import loops pay nothing in normal builds.
+enum ProfileCounter
+{
+    COUNTER_DATE_COMPARISONS, //TimSort::is_less_than calls.
+    COUNTER_NODES_ALLOCATED,  //Articles added by LinkedList::pushback / insert.
+    COUNTER_COUNT
+};
+
+const char* profile_counter_name(ProfileCounter counter)
+{
+    static const char* const names[COUNTER_COUNT] = { "date_comparisons", "nodes_allocated" };
+    return names[counter];
+}
+
+atomic<uint64_t>* profile_counters()
+{
+    static atomic<uint64_t> counters[COUNTER_COUNT];
+    return counters;
+}
+
+#ifdef NEWS_PROFILE_EVENTS
+#define PROFILE_COUNT(counter) profile_counters()[counter].fetch_add(1, memory_order_relaxed)
+#else
+#define PROFILE_COUNT(counter) ((void)0)
+#endif
+
+//Global allocation counters. Only active when NEWS_COUNT_ALLOCATIONS is defined, in which case this header
+//replaces the global operator new/delete and must be included by exactly one translation unit (each program
+//in this repo is a single one).
+struct AllocationCounters
+{
+    atomic<uint64_t> allocations{0};
+    atomic<uint64_t> bytes{0};
+};
+
+AllocationCounters& allocation_counters()
+{
+    static AllocationCounters counters;
+    return counters;
+}
+
+#ifdef NEWS_COUNT_ALLOCATIONS
+void* operator new(size_t size)
+{
+    AllocationCounters& counters = allocation_counters();
+    counters.allocations.fetch_add(1, memory_order_relaxed);
+    counters.bytes.fetch_add(size, memory_order_relaxed);
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+
+//Kept out of line so the compiler does not pair the inlined free() with new-expressions and warn.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void counted_free(void* p) noexcept
+{
+    free(p);
+}
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, size_t) noexcept { counted_free(p); }
+#endif
+
+//Current resident set size in bytes (not the peak).
+size_t getCurrentMemoryUsage()
+{
+    #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memInfo;
+    GetProcessMemoryInfo(GetCurrentProcess(), &memInfo, sizeof(memInfo));
+    return memInfo.WorkingSetSize;  // Return memory usage in bytes
+    #else
+    // /proc/self/statm: size resident shared ... (in pages)
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    unsigned long size = 0, resident = 0;
+    int read = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    return (read == 2) ? resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+    #endif
+}
+
+//Peak resident set size in bytes.
+size_t getPeakMemoryUsage()
+{
+    #ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS memInfo;
+    GetProcessMemoryInfo(GetCurrentProcess(), &memInfo, sizeof(memInfo));
+    return memInfo.PeakWorkingSetSize;
+    #else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss * 1024;  // ru_maxrss is in KB on Linux
+    #endif
+}
+
+//What one PhaseTimer measured.
+struct PhaseRecord
+{
+    string name;
+    double milliseconds;
+    size_t rssBefore;
+    size_t rssAfter;
+    uint64_t allocations;
+    uint64_t allocatedBytes;
+    uint64_t events[COUNTER_COUNT];
+};
+
+//Collects phase records and writes them as a JSON report.
+class Profiler
+{
+    public:
+        void record(const PhaseRecord& phase)
+        {
+            phases.push_back(phase);
+        }
+
+        const vector<PhaseRecord>& getPhases() const
+        {
+            return phases;
+        }
+
+        //Most recent record with this name, or nullptr.
+        const PhaseRecord* find(const string& name) const
+        {
+            for (size_t i = phases.size(); i > 0; i--)
+            {
+                if (phases[i - 1].name == name) return &phases[i - 1];
+            }
+            return nullptr;
+        }
+
+        void writeJson(ostream& out) const
+        {
+            out << "{\n  \"event_counting\": " << (eventCountingEnabled() ? "true" : "false")
+                << ",\n  \"allocation_counting\": " << (allocationCountingEnabled() ? "true" : "false")
+                << ",\n  \"peak_rss_bytes\": " << getPeakMemoryUsage()
+                << ",\n  \"phases\": [";
+            for (size_t i = 0; i < phases.size(); i++)
+            {
+                const PhaseRecord& phase = phases[i];
+                out << (i == 0 ? "\n" : ",\n")
+                    << "    {\"name\": \"" << jsonEscape(phase.name) << "\""
+                    << ", \"ms\": " << phase.milliseconds
+                    << ", \"rss_before_bytes\": " << phase.rssBefore
+                    << ", \"rss_after_bytes\": " << phase.rssAfter
+                    << ", \"rss_delta_bytes\": " << static_cast<long long>(phase.rssAfter) - static_cast<long long>(phase.rssBefore)
+                    << ", \"allocations\": " << phase.allocations
+                    << ", \"allocated_bytes\": " << phase.allocatedBytes
+                    << ", \"events\": {";
+                for (int c = 0; c < COUNTER_COUNT; c++)
+                {
+                    out << (c == 0 ? "" : ", ") << "\"" << profile_counter_name(static_cast<ProfileCounter>(c)) << "\": " << phase.events[c];
+                }
+                out << "}}";
+            }
+            out << "\n  ],\n  \"counters\": {";
+            for (int c = 0; c < COUNTER_COUNT; c++)
+            {
+                out << (c == 0 ? "" : ", ") << "\"" << profile_counter_name(static_cast<ProfileCounter>(c)) << "\": "
+                    << profile_counters()[c].load(memory_order_relaxed);
+            }
+            out << "}\n}\n";
+        }
+
+        bool saveJson(const string& filename) const
+        {
+            ofstream file(filename);
+            if (!file.is_open()) return false;
+            writeJson(file);
+            return true;
+        }
+
+        static bool eventCountingEnabled()
+        {
+            #ifdef NEWS_PROFILE_EVENTS
+            return true;
+            #else
+            return false;
+            #endif
+        }
+
+        static bool allocationCountingEnabled()
+        {
+            #ifdef NEWS_COUNT_ALLOCATIONS
+            return true;
+            #else
+            return false;
+            #endif
+        }
+
+    private:
+        vector<PhaseRecord> phases;
+
+        static string jsonEscape(const string& text)
+        {
+            string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\') escaped.push_back('\\');
+                if (static_cast<unsigned char>(c) < 0x20) continue;
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+};
+
+Profiler& profiler()
+{
+    static Profiler instance;
+    return instance;
+}
+
+//Times the enclosing scope and records it with the global profiler: wall time, current RSS before and after,
+//allocations made and event counters bumped during the scope.
+class PhaseTimer
+{
+    public:
+        explicit PhaseTimer(const string& name)
+        {
+            record.name = name;
+            record.rssBefore = getCurrentMemoryUsage();
+            allocationsBefore = allocation_counters().allocations.load(memory_order_relaxed);
+            bytesBefore = allocation_counters().bytes.load(memory_order_relaxed);
+            for (int c = 0; c < COUNTER_COUNT; c++)
+            {
+                eventsBefore[c] = profile_counters()[c].load(memory_order_relaxed);
+            }
+            start = chrono::steady_clock::now();
+        }
+
+        ~PhaseTimer()
+        {
+            record.milliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            record.rssAfter = getCurrentMemoryUsage();
+            record.allocations = allocation_counters().allocations.load(memory_order_relaxed) - allocationsBefore;
+            record.allocatedBytes = allocation_counters().bytes.load(memory_order_relaxed) - bytesBefore;
+            for (int c = 0; c < COUNTER_COUNT; c++)
+            {
+                record.events[c] = profile_counters()[c].load(memory_order_relaxed) - eventsBefore[c];
+            }
+            profiler().record(record);
+        }
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        PhaseRecord record;
+        chrono::steady_clock::time_point start;
+        uint64_t allocationsBefore;
+        uint64_t bytesBefore;
+        uint64_t eventsBefore[COUNTER_COUNT];
+};
+
+#endif
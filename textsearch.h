@@ -0,0 +1,190 @@
+#ifndef TEXTSEARCH_H
+#define TEXTSEARCH_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXT_SEARCH_SSE2 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TEXT_SEARCH_AVX2 1 //Compiled with a target attribute and only called when the CPU reports AVX2.
+#endif
+
+using namespace std;
+
+//ASCII lowercase of one byte; other bytes (including UTF-8) are left alone, like ::tolower in the C locale.
+char fold_ascii(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+//Case-insensitive (ASCII) substring search over the original bytes, without making a lowercase copy.
+//Candidate positions are those where both the needle's first and last bytes match, in either case; the
+//vector kernels test 16 (SSE2) or 32 (AVX2) positions per step that way and only compare the middle bytes
+//of the candidates. The kernel is picked once per process from what the CPU supports.
+class CaseInsensitiveSearcher
+{
+    public:
+        explicit CaseInsensitiveSearcher(string_view needle)
+        {
+            lowerNeedle.reserve(needle.size());
+            for (char c : needle) lowerNeedle.push_back(fold_ascii(c));
+            if (!lowerNeedle.empty())
+            {
+                firstLower = lowerNeedle.front();
+                lastLower = lowerNeedle.back();
+                firstUpper = upper(firstLower);
+                lastUpper = upper(lastLower);
+            }
+        }
+
+        //Offset of the first match in text, or string_view::npos. An empty needle matches at 0.
+        size_t find(string_view text) const
+        {
+            if (lowerNeedle.empty()) return 0;
+            if (lowerNeedle.size() > text.size()) return string_view::npos;
+            return kernel()(*this, text.data(), text.size());
+        }
+
+        bool contains(string_view text) const
+        {
+            return find(text) != string_view::npos;
+        }
+
+        const string& needle() const
+        {
+            return lowerNeedle;
+        }
+
+        //Name of the kernel in use: "avx2", "sse2" or "scalar".
+        static const char* kernelName()
+        {
+            Kernel k = kernel();
+            #ifdef TEXT_SEARCH_AVX2
+            if (k == find_avx2) return "avx2";
+            #endif
+            #ifdef TEXT_SEARCH_SSE2
+            if (k == find_sse2) return "sse2";
+            #endif
+            return k == find_scalar ? "scalar" : "unknown";
+        }
+
+    private:
+        typedef size_t (*Kernel)(const CaseInsensitiveSearcher&, const char*, size_t);
+
+        string lowerNeedle;
+        char firstLower = 0, firstUpper = 0, lastLower = 0, lastUpper = 0;
+
+        static char upper(char c)
+        {
+            return (c >= 'a' && c <= 'z') ? static_cast<char>(c & ~0x20) : c;
+        }
+
+        static Kernel kernel()
+        {
+            static const Kernel selected = select_kernel();
+            return selected;
+        }
+
+        static Kernel select_kernel()
+        {
+            #ifdef TEXT_SEARCH_AVX2
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return find_avx2;
+            #endif
+            #ifdef TEXT_SEARCH_SSE2
+            return find_sse2;
+            #else
+            return find_scalar;
+            #endif
+        }
+
+        // Does the needle match at text (first and last bytes already known to match)?
+        bool matches_middle(const char* text) const
+        {
+            for (size_t k = 1; k + 1 < lowerNeedle.size(); k++)
+            {
+                if (fold_ascii(text[k]) != lowerNeedle[k]) return false;
+            }
+            return true;
+        }
+
+        // Scalar scan of positions [from, last], used for whole texts and for the vector kernels' tails.
+        size_t scan(const char* text, size_t from, size_t last) const
+        {
+            size_t n = lowerNeedle.size();
+            for (size_t i = from; i <= last; i++)
+            {
+                char first = text[i];
+                if (first != firstLower && first != firstUpper) continue;
+                char end = text[i + n - 1];
+                if ((end == lastLower || end == lastUpper) && matches_middle(text + i)) return i;
+            }
+            return string_view::npos;
+        }
+
+        static size_t find_scalar(const CaseInsensitiveSearcher& s, const char* text, size_t length)
+        {
+            return s.scan(text, 0, length - s.lowerNeedle.size());
+        }
+
+        #ifdef TEXT_SEARCH_SSE2
+        static size_t find_sse2(const CaseInsensitiveSearcher& s, const char* text, size_t length)
+        {
+            size_t n = s.lowerNeedle.size();
+            size_t last = length - n; //Last possible match position.
+            const __m128i firstLo = _mm_set1_epi8(s.firstLower), firstUp = _mm_set1_epi8(s.firstUpper);
+            const __m128i lastLo = _mm_set1_epi8(s.lastLower), lastUp = _mm_set1_epi8(s.lastUpper);
+            size_t i = 0;
+            for (; i + 16 <= last + 1; i += 16)
+            {
+                __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+                __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + n - 1));
+                __m128i firstHit = _mm_or_si128(_mm_cmpeq_epi8(head, firstLo), _mm_cmpeq_epi8(head, firstUp));
+                __m128i lastHit = _mm_or_si128(_mm_cmpeq_epi8(tail, lastLo), _mm_cmpeq_epi8(tail, lastUp));
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(firstHit, lastHit)));
+                while (mask != 0)
+                {
+                    size_t candidate = i + __builtin_ctz(mask);
+                    if (s.matches_middle(text + candidate)) return candidate;
+                    mask &= mask - 1;
+                }
+            }
+            return i <= last ? s.scan(text, i, last) : string_view::npos;
+        }
+        #endif
+
+        #ifdef TEXT_SEARCH_AVX2
+        __attribute__((target("avx2")))
+        static size_t find_avx2(const CaseInsensitiveSearcher& s, const char* text, size_t length)
+        {
+            size_t n = s.lowerNeedle.size();
+            size_t last = length - n;
+            const __m256i firstLo = _mm256_set1_epi8(s.firstLower), firstUp = _mm256_set1_epi8(s.firstUpper);
+            const __m256i lastLo = _mm256_set1_epi8(s.lastLower), lastUp = _mm256_set1_epi8(s.lastUpper);
+            size_t i = 0;
+            for (; i + 32 <= last + 1; i += 32)
+            {
+                __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+                __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + n - 1));
+                __m256i firstHit = _mm256_or_si256(_mm256_cmpeq_epi8(head, firstLo), _mm256_cmpeq_epi8(head, firstUp));
+                __m256i lastHit = _mm256_or_si256(_mm256_cmpeq_epi8(tail, lastLo), _mm256_cmpeq_epi8(tail, lastUp));
+                unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(firstHit, lastHit)));
+                while (mask != 0)
+                {
+                    size_t candidate = i + __builtin_ctz(mask);
+                    if (s.matches_middle(text + candidate)) return candidate;
+                    mask &= mask - 1;
+                }
+            }
+            return i <= last ? s.scan(text, i, last) : string_view::npos;
+        }
+        #endif
+};
+
+#endif
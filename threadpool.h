@@ -0,0 +1,225 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <exception>
+
+using namespace std;
+
+//Work-stealing thread pool. Every worker owns a task deque: it pops its own newest task first and, when that
+//is empty, steals the oldest task of another worker. Tasks submitted from outside the pool are spread over
+//the deques round-robin. A pool of n threads starts n - 1 workers, because the thread that waits on a
+//TaskGroup runs tasks as well; ThreadPool(1) therefore runs everything on the calling thread.
+class ThreadPool
+{
+    public:
+        explicit ThreadPool(unsigned threadCount = thread::hardware_concurrency())
+        {
+            if (threadCount == 0) threadCount = 1;
+            for (unsigned i = 0; i < threadCount; i++)
+            {
+                queues.emplace_back(new WorkQueue());
+            }
+            for (unsigned i = 1; i < threadCount; i++)
+            {
+                workers.emplace_back([this, i]() { workerLoop(i); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                lock_guard<mutex> guard(sleepLock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //Threads that run tasks, counting the waiting thread.
+        unsigned size() const
+        {
+            return static_cast<unsigned>(queues.size());
+        }
+
+        void submit(function<void()> task)
+        {
+            size_t index = (currentPool == this) ? currentWorker : nextQueue.fetch_add(1, memory_order_relaxed) % queues.size();
+            {
+                lock_guard<mutex> guard(queues[index]->lock);
+                queues[index]->tasks.push_back(move(task));
+            }
+            {
+                lock_guard<mutex> guard(sleepLock);
+                queued++;
+            }
+            wake.notify_one();
+        }
+
+        //Run one queued task on the calling thread; false if every deque was empty.
+        bool runPendingTask()
+        {
+            size_t home = (currentPool == this) ? currentWorker : 0;
+            function<void()> task;
+            if (!takeTask(home, task)) return false;
+            task();
+            return true;
+        }
+
+    private:
+        struct WorkQueue
+        {
+            mutex lock;
+            deque<function<void()>> tasks;
+        };
+
+        vector<unique_ptr<WorkQueue>> queues;
+        vector<thread> workers;
+        atomic<size_t> nextQueue{0};
+        mutex sleepLock;
+        condition_variable wake;
+        size_t queued = 0; //Guarded by sleepLock.
+        bool stopping = false;
+
+        static thread_local ThreadPool* currentPool;
+        static thread_local size_t currentWorker;
+
+        //Own deque from the back (newest), then the other deques from the front (oldest).
+        bool takeTask(size_t home, function<void()>& task)
+        {
+            for (size_t k = 0; k < queues.size(); k++)
+            {
+                size_t index = (home + k) % queues.size();
+                WorkQueue& queue = *queues[index];
+                lock_guard<mutex> guard(queue.lock);
+                if (queue.tasks.empty()) continue;
+                if (k == 0)
+                {
+                    task = move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                lock_guard<mutex> count(sleepLock);
+                queued--;
+                return true;
+            }
+            return false;
+        }
+
+        void workerLoop(size_t index)
+        {
+            currentPool = this;
+            currentWorker = index;
+            function<void()> task;
+            while (true)
+            {
+                if (takeTask(index, task))
+                {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                unique_lock<mutex> guard(sleepLock);
+                wake.wait(guard, [this]() { return queued > 0 || stopping; });
+                if (stopping && queued == 0) return;
+            }
+        }
+};
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorker = 0;
+
+//A set of tasks on a pool that can be waited for. wait() runs queued tasks while it waits, so groups can be
+//nested inside pool tasks without blocking a worker. The first exception thrown by a task is rethrown by wait().
+class TaskGroup
+{
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+        ~TaskGroup()
+        {
+            // Tasks reference the group, so never leave while any are outstanding.
+            while (pending.load(memory_order_acquire) > 0)
+            {
+                if (!pool.runPendingTask()) this_thread::yield();
+            }
+        }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template <typename F>
+        void run(F task)
+        {
+            pending.fetch_add(1, memory_order_relaxed);
+            pool.submit([this, task]()
+            {
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    lock_guard<mutex> guard(errorLock);
+                    if (!error) error = current_exception();
+                }
+                pending.fetch_sub(1, memory_order_release);
+            });
+        }
+
+        void wait()
+        {
+            while (pending.load(memory_order_acquire) > 0)
+            {
+                if (!pool.runPendingTask()) this_thread::yield();
+            }
+            lock_guard<mutex> guard(errorLock);
+            if (error)
+            {
+                exception_ptr thrown = error;
+                error = nullptr;
+                rethrow_exception(thrown);
+            }
+        }
+
+    private:
+        ThreadPool& pool;
+        atomic<size_t> pending{0};
+        mutex errorLock;
+        exception_ptr error;
+};
+
+//Run f(begin, end) over [0, count) split into at most pieces contiguous ranges, in parallel on the pool.
+template <typename F>
+void parallel_for_ranges(ThreadPool& pool, size_t count, size_t pieces, F f)
+{
+    if (pieces == 0) pieces = 1;
+    if (pieces > count) pieces = count;
+    TaskGroup group(pool);
+    for (size_t i = 0; i < pieces; i++)
+    {
+        size_t begin = count * i / pieces;
+        size_t end = count * (i + 1) / pieces;
+        group.run([&f, begin, end]() { f(begin, end); });
+    }
+    group.wait();
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include "textsearch.h"
+#include <string_view>
+#include <vector>
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+//English stop words (NLTK's list). Every entry must be distinct and lowercase.
+constexpr string_view STOP_WORDS[] = {
+    "i", "me", "my", "myself", "we", "our", "ours", "ourselves", "you", "you're", "you've", "you'll",
+    "you'd", "your", "yours", "yourself", "yourselves", "he", "him", "his", "himself", "she", "she's",
+    "her", "hers", "herself", "it", "it's", "its", "itself", "they", "them", "their", "theirs",
+    "themselves", "what", "which", "who", "whom", "this", "that", "that'll", "these", "those", "am", "is",
+    "are", "was", "were", "be", "been", "being", "have", "has", "had", "having", "do", "does", "did",
+    "doing", "a", "an", "the", "and", "but", "if", "or", "because", "as", "until", "while", "of", "at",
+    "by", "for", "with", "about", "against", "between", "into", "through", "during", "before", "after",
+    "above", "below", "to", "from", "up", "down", "in", "out", "on", "off", "over", "under", "again",
+    "further", "then", "once", "here", "there", "when", "where", "why", "how", "all", "any", "both",
+    "each", "few", "more", "most", "other", "some", "such", "no", "nor", "not", "only", "own", "same",
+    "so", "than", "too", "very", "s", "t", "can", "will", "just", "don", "don't", "should", "should've",
+    "now", "d", "ll", "m", "o", "re", "ve", "y", "ain", "aren", "aren't", "couldn", "couldn't", "didn",
+    "didn't", "doesn", "doesn't", "hadn", "hadn't", "hasn", "hasn't", "haven", "haven't", "isn", "isn't",
+    "ma", "mightn", "mightn't", "mustn", "mustn't", "needn", "needn't", "shan", "shan't", "shouldn",
+    "shouldn't", "wasn", "wasn't", "weren", "weren't", "won", "won't", "wouldn", "wouldn't"
+};
+constexpr size_t STOP_WORD_COUNT = sizeof(STOP_WORDS) / sizeof(STOP_WORDS[0]);
+
+//Perfect hash table over STOP_WORDS, built at compile time: a seed is searched for that sends every word to its
+//own slot, so a lookup is one hash, one slot load and one compare.
+struct StopWordTable
+{
+    static constexpr unsigned BITS = 12;
+    static constexpr size_t SIZE = size_t(1) << BITS;
+    static constexpr uint8_t EMPTY = UINT8_MAX;
+
+    uint64_t seed;
+    uint8_t slots[SIZE]; //Slot -> index into STOP_WORDS, or EMPTY.
+    size_t maxLength;    //Longer words are rejected without hashing.
+};
+static_assert(STOP_WORD_COUNT < StopWordTable::EMPTY, "Too many stop words for 8-bit slots.");
+
+//FNV-1a from a seeded basis, spread over the table by a multiplicative hash into the top bits.
+constexpr size_t stop_word_slot(string_view word, uint64_t seed)
+{
+    uint64_t h = 14695981039346656037ULL ^ seed;
+    for (char c : word)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>((h * 0x9E3779B97F4A7C15ULL) >> (64 - StopWordTable::BITS));
+}
+
+//Try seeds until no two words share a slot. Fails to compile if none is found (or a word is listed twice).
+constexpr StopWordTable build_stop_word_table()
+{
+    for (uint64_t seed = 0; seed < 4096; seed++)
+    {
+        StopWordTable table = { seed, {}, 0 };
+        for (size_t s = 0; s < StopWordTable::SIZE; s++) table.slots[s] = StopWordTable::EMPTY;
+        bool collision = false;
+        for (size_t w = 0; w < STOP_WORD_COUNT && !collision; w++)
+        {
+            size_t s = stop_word_slot(STOP_WORDS[w], seed);
+            collision = table.slots[s] != StopWordTable::EMPTY;
+            table.slots[s] = static_cast<uint8_t>(w);
+            if (STOP_WORDS[w].size() > table.maxLength) table.maxLength = STOP_WORDS[w].size();
+        }
+        if (!collision) return table;
+    }
+    throw logic_error("No perfect hash seed for the stop word table.");
+}
+
+constexpr StopWordTable STOP_WORD_TABLE = build_stop_word_table();
+
+//True if word (already lowercase) is a stop word.
+bool is_stop_word(string_view word)
+{
+    if (word.empty() || word.size() > STOP_WORD_TABLE.maxLength) return false;
+    uint8_t slot = STOP_WORD_TABLE.slots[stop_word_slot(word, STOP_WORD_TABLE.seed)];
+    return slot != StopWordTable::EMPTY && STOP_WORDS[slot] == word;
+}
+
+//Splits text into lowercase words without allocating per word: words are whitespace-separated, with leading and
+//trailing ASCII punctuation stripped (inner punctuation such as "u.s." or "don't" stays), the same rules the
+//stringstream-based extraction used. Each word is folded into a scratch buffer at its own offset, so the views
+//handed out stay valid until the next call, and the buffer is reused across texts.
+class WordTokenizer
+{
+    public:
+        explicit WordTokenizer(bool dropStopWords = true) : dropStopWords(dropStopWords) {}
+
+        //Call f(word) for each word of text, in order.
+        template <typename F>
+        void forEachWord(string_view text, F f)
+        {
+            if (buffer.size() < text.size())
+            {
+                buffer.resize(text.size());
+            }
+            size_t i = 0;
+            while (i < text.size())
+            {
+                while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+                size_t start = i;
+                while (i < text.size() && !isspace(static_cast<unsigned char>(text[i]))) i++;
+                size_t end = i;
+                while (start < end && ispunct(static_cast<unsigned char>(text[start]))) start++;
+                while (end > start && ispunct(static_cast<unsigned char>(text[end - 1]))) end--;
+                if (start == end) continue;
+
+                for (size_t k = start; k < end; k++)
+                {
+                    buffer[k] = fold_ascii(text[k]);
+                }
+                string_view word(buffer.data() + start, end - start);
+                if (dropStopWords && is_stop_word(word)) continue;
+                f(word);
+            }
+        }
+
+    private:
+        vector<char> buffer;
+        bool dropStopWords;
+};
+
+#endif
@@ -0,0 +1,376 @@
+#ifndef UNROLLEDLIST_H
+#define UNROLLEDLIST_H
+
+#include "linkedlist.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+//Unrolled linked list: articles are stored by value in blocks, so a sequential scan reads consecutive memory, with
+//one allocation per block instead of per article. A block index (the position of each block's first article) is
+//binary searched for positional access, so get() is O(log n). insert() and erase() shift articles inside one block,
+//split a full block or merge an underfull one into its neighbour, and then renumber the blocks after it, which costs
+//O(B + n / B) for blocks of B articles. B starts at MinBlockCapacity and insert() / erase() keep it near sqrt(n):
+//when n has moved fourfold or more from B^2 the articles are regrouped into blocks of the new size (O(n), so
+//O(1) amortized over the operations that changed n), so insert() and erase() are O(sqrt(n)) amortized.
+//The articles stay chained through next in list order, so code that walks getHead()/next or uses the Iterator
+//works unchanged (it is LinkedList's Iterator). Unlike LinkedList, insert(), erase() and popfront() move the articles
+//of the blocks they touch (or all of them on a regroup), so pointers into the list (e.g. held by an index) are
+//invalidated; pushback() and splice_back() never move existing articles.
+//Sorting relinks next pointers; hand the new head to setHead(), which moves the articles into that order.
+template <typename T, size_t MinBlockCapacity = 128>
+class UnrolledList
+{
+    static_assert(MinBlockCapacity >= 4, "UnrolledList blocks must hold at least 4 articles.");
+
+    private:
+        typedef vector<Article<T>> Block; //Reserved when created, and never filled past that, so articles never move on push_back.
+
+        vector<Block> blocks;
+        vector<size_t> starts; //Position of the first article of each block.
+        size_t size;
+        size_t blockCapacity;  //Articles per full block (B).
+
+    public:
+        typedef typename LinkedList<T>::Iterator Iterator;
+
+        UnrolledList() : size(0), blockCapacity(MinBlockCapacity) {}
+        UnrolledList(const UnrolledList&) = delete;
+        UnrolledList& operator=(const UnrolledList&) = delete;
+
+        //Adding articles to the list tail; fills the last block and starts a new one when it is full.
+        void pushback(T Title, T Content, T Category, T Date, T Label, int DateKey = 0)
+        {
+            emplace_back(move(Title), move(Content), move(Category), move(Date), move(Label), DateKey);
+        }
+
+        //Build an article in place at the tail from the Article constructor's arguments.
+        template <typename... Args>
+        Article<T>* emplace_back(Args&&... args)
+        {
+            Article<T>* previous = size == 0 ? nullptr : &blocks.back().back();
+            if (blocks.empty() || blocks.back().size() >= blockCapacity || blocks.back().size() == blocks.back().capacity())
+            {
+                blocks.emplace_back();
+                blocks.back().reserve(blockCapacity);
+                starts.push_back(size);
+            }
+            blocks.back().emplace_back(forward<Args>(args)...);
+            PROFILE_COUNT(COUNTER_NODES_ALLOCATED);
+            if (previous != nullptr)
+            {
+                previous -> next = &blocks.back().back();
+            }
+            size++;
+            return &blocks.back().back();
+        }
+
+        //Remove first article from the list.
+        void popfront()
+        {
+            if (size == 0)
+            {
+                throw out_of_range("Pop front failed due to the list is empty.");
+            }
+            erase(0);
+        }
+
+        bool contains(const T& Title) const
+        {
+            for (const Block& block : blocks)
+            {
+                for (const Article<T>& article : block)
+                {
+                    if (article.Title == Title)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        //Article at a position, found through the block index in O(log n).
+        Article<T>* get(size_t index) const
+        {
+            if (index >= size)
+            {
+                throw out_of_range("Index out of range.");
+            }
+            size_t b = locate(index);
+            return const_cast<Article<T>*>(&blocks[b][index - starts[b]]);
+        }
+
+        Article<T>* getNode(size_t index) const
+        {
+            return get(index);
+        }
+
+        //Insert an article before position index (index == size appends).
+        void insert(size_t index, T Title, T Content, T Category, T Date, T Label, int DateKey = 0)
+        {
+            emplace(index, move(Title), move(Content), move(Category), move(Date), move(Label), DateKey);
+        }
+
+        //Build an article in place before position index, like emplace_back.
+        template <typename... Args>
+        Article<T>* emplace(size_t index, Args&&... args)
+        {
+            if (index > size)
+            {
+                throw out_of_range("Index out of range.");
+            }
+            if (index == size)
+            {
+                return emplace_back(forward<Args>(args)...);
+            }
+
+            rebalance(size + 1);
+            size_t b = locate(index);
+            size_t offset = index - starts[b];
+            if (blocks[b].size() >= blockCapacity)
+            {
+                // Split the full block in half and insert into whichever half holds the position.
+                split(b);
+                if (offset > blocks[b].size())
+                {
+                    offset -= blocks[b].size();
+                    b++;
+                }
+            }
+            Block& block = blocks[b];
+            block.emplace(block.begin() + offset, forward<Args>(args)...);
+            PROFILE_COUNT(COUNTER_NODES_ALLOCATED);
+            size++;
+            relink(b);
+            renumber(b + 1);
+            return &block[offset];
+        }
+
+        //Erase the article at a position. A block that drops below a quarter full is merged into a neighbour
+        //when the two fit in one block.
+        void erase(size_t index)
+        {
+            if (index >= size)
+            {
+                throw out_of_range("Index out of range.");
+            }
+            rebalance(size - 1);
+            size_t b = locate(index);
+            blocks[b].erase(blocks[b].begin() + (index - starts[b]));
+            size--;
+
+            if (blocks[b].empty())
+            {
+                blocks.erase(blocks.begin() + b);
+                starts.erase(starts.begin() + b);
+                if (b > 0) relink(b - 1);
+                else if (!blocks.empty()) relink(0);
+                renumber(b);
+                return;
+            }
+            if (blocks[b].size() < blockCapacity / 4)
+            {
+                if (b + 1 < blocks.size() && blocks[b].size() + blocks[b + 1].size() <= blockCapacity)
+                {
+                    join(b);
+                }
+                else if (b > 0 && blocks[b - 1].size() + blocks[b].size() <= blockCapacity)
+                {
+                    b--;
+                    join(b);
+                }
+            }
+            relink(b);
+            renumber(b + 1);
+        }
+
+        //Move every article of other to the end of this list; other is left empty. Blocks are moved, not copied.
+        void splice_back(UnrolledList& other)
+        {
+            if (other.size == 0)
+            {
+                return;
+            }
+            size_t first = blocks.size();
+            for (Block& block : other.blocks)
+            {
+                blocks.push_back(move(block));
+                starts.push_back(0);
+            }
+            size += other.size;
+            if (first > 0)
+            {
+                relink(first - 1);
+            }
+            renumber(first);
+            other.clear();
+        }
+
+        size_t getSize() const
+        {
+            return size;
+        }
+
+        size_t blockCount() const
+        {
+            return blocks.size();
+        }
+
+        void clear()
+        {
+            blocks.clear();
+            starts.clear();
+            size = 0;
+            blockCapacity = MinBlockCapacity;
+        }
+
+        Iterator begin() const
+        {
+            return Iterator(getHead());
+        }
+
+        Iterator end() const
+        {
+            return Iterator(nullptr);
+        }
+
+        void display() const
+        {
+            for (Iterator it = begin(); it != end(); ++it)
+            {
+                cout << "----------------------------------------------------------" << endl
+                     << "Title:" << it -> Title << "\n"
+                     << "Content:" << it -> Content << "\n"
+                     << "Category:" << it -> Category << "\n"
+                     << "Date:" << it -> Date << "\n"
+                     << "Label:" << it -> Label << "\n\n"
+                     << "----------------------------------------------------------" << endl;
+            }
+        }
+
+        Article<T>* getHead() const
+        {
+            return blocks.empty() ? nullptr : const_cast<Article<T>*>(&blocks.front().front());
+        }
+
+        //Adopt a new order after the next pointers were relinked (e.g. by RadixSort::radixSort(head)): the
+        //articles are moved into fresh, full blocks following the chain from newHead. O(n). The chain is checked
+        //before anything is moved, so a bad chain leaves the list as it was.
+        void setHead(Article<T>* newHead)
+        {
+            size_t count = 0;
+            for (Article<T>* current = newHead; current != nullptr && count <= size; current = current -> next)
+            {
+                count++;
+            }
+            if (count != size)
+            {
+                throw logic_error("UnrolledList::setHead: the chain does not hold every article of the list.");
+            }
+            regroup(newHead, blockCapacity);
+        }
+
+        //The tail follows from the block order; kept so sorting code written for LinkedList can call it.
+        void setTail(Article<T>*) {}
+
+    private:
+        // Move the articles, in chain order from head, into full blocks of capacity articles.
+        void regroup(Article<T>* head, size_t capacity)
+        {
+            vector<Block> ordered;
+            ordered.reserve((size + capacity - 1) / capacity);
+            for (Article<T>* current = head; current != nullptr; )
+            {
+                Article<T>* next = current -> next;
+                if (ordered.empty() || ordered.back().size() == capacity)
+                {
+                    ordered.emplace_back();
+                    ordered.back().reserve(capacity);
+                }
+                ordered.back().push_back(move(*current));
+                current = next;
+            }
+            blocks.swap(ordered);
+            blockCapacity = capacity;
+            starts.assign(blocks.size(), 0);
+            for (size_t b = 0; b < blocks.size(); b++)
+            {
+                relink(b);
+            }
+            renumber(0);
+        }
+
+        // Keep B within a factor of four of sqrt(n) (and at least MinBlockCapacity) for a list about to hold
+        // expected articles. A regroup sets B to the power-of-two multiple of MinBlockCapacity in [sqrt(n), 2 sqrt(n)),
+        // so the next one needs n to grow or shrink at least fourfold.
+        void rebalance(size_t expected)
+        {
+            size_t target = MinBlockCapacity;
+            while (target * target < expected) target *= 2;
+            if (target > blockCapacity * 2 || (blockCapacity > MinBlockCapacity && target * 2 < blockCapacity))
+            {
+                regroup(getHead(), target);
+            }
+        }
+
+        // Block holding position index.
+        size_t locate(size_t index) const
+        {
+            return static_cast<size_t>(upper_bound(starts.begin(), starts.end(), index) - starts.begin()) - 1;
+        }
+
+        // Restore the next pointers inside block b and from the block before it.
+        void relink(size_t b)
+        {
+            Block& block = blocks[b];
+            for (size_t i = 0; i + 1 < block.size(); i++)
+            {
+                block[i].next = &block[i + 1];
+            }
+            block.back().next = b + 1 < blocks.size() ? &blocks[b + 1].front() : nullptr;
+            if (b > 0)
+            {
+                blocks[b - 1].back().next = &block.front();
+            }
+        }
+
+        // Recompute the block index from block b onwards.
+        void renumber(size_t b)
+        {
+            for (; b < blocks.size(); b++)
+            {
+                starts[b] = b == 0 ? 0 : starts[b - 1] + blocks[b - 1].size();
+            }
+        }
+
+        // Move the second half of block b into a new block after it.
+        void split(size_t b)
+        {
+            Block upper;
+            upper.reserve(blockCapacity);
+            size_t half = blocks[b].size() / 2;
+            move(blocks[b].begin() + half, blocks[b].end(), back_inserter(upper));
+            blocks[b].erase(blocks[b].begin() + half, blocks[b].end());
+            blocks.insert(blocks.begin() + b + 1, move(upper));
+            starts.insert(starts.begin() + b + 1, 0);
+            relink(b + 1);
+            renumber(b + 1);
+        }
+
+        // Append block b + 1 to block b and drop it.
+        void join(size_t b)
+        {
+            Block& next = blocks[b + 1];
+            move(next.begin(), next.end(), back_inserter(blocks[b]));
+            blocks.erase(blocks.begin() + b + 1);
+            starts.erase(starts.begin() + b + 1);
+        }
+};
+
+#endif
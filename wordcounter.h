@@ -0,0 +1,191 @@
+#ifndef WORDCOUNTER_H
+#define WORDCOUNTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+struct WordCount
+{
+    string_view word;
+    uint64_t frequency;
+};
+
+//Word frequency counter: an open-addressing hash table (linear probing) whose slots keep each key's
+//precomputed hash, with the key bytes stored once in a shared arena. Growing rehashes from the stored
+//hashes, so keys are never hashed twice or compared unless the hashes match.
+class WordCounter
+{
+    public:
+        explicit WordCounter(size_t initialCapacity = 1024)
+        {
+            size_t capacity = 16;
+            while (capacity < initialCapacity) capacity *= 2;
+            slots.resize(capacity);
+        }
+
+        //FNV-1a, 64-bit.
+        static uint64_t hash(string_view word)
+        {
+            uint64_t h = 14695981039346656037ULL;
+            for (unsigned char c : word)
+            {
+                h ^= c;
+                h *= 1099511628211ULL;
+            }
+            return h;
+        }
+
+        void addWord(string_view word, uint64_t count = 1)
+        {
+            addWord(word, hash(word), count);
+        }
+
+        //Add a word whose hash the caller already computed.
+        void addWord(string_view word, uint64_t wordHash, uint64_t count)
+        {
+            // A zero count would fill a slot that still reads as empty.
+            if (count == 0) return;
+            if ((used + 1) * 10 > slots.size() * 7)
+            {
+                grow();
+            }
+            size_t mask = slots.size() - 1;
+            for (size_t i = wordHash & mask; ; i = (i + 1) & mask)
+            {
+                Slot& slot = slots[i];
+                if (slot.count == 0)
+                {
+                    if (arena.size() + word.size() > UINT32_MAX)
+                    {
+                        throw length_error("WordCounter key arena is full.");
+                    }
+                    slot.hash = wordHash;
+                    slot.offset = static_cast<uint32_t>(arena.size());
+                    slot.length = static_cast<uint32_t>(word.size());
+                    slot.count = count;
+                    arena.insert(arena.end(), word.begin(), word.end());
+                    used++;
+                    total += count;
+                    return;
+                }
+                if (slot.hash == wordHash && key(slot) == word)
+                {
+                    slot.count += count;
+                    total += count;
+                    return;
+                }
+            }
+        }
+
+        //Frequency of a word, 0 if it was never added.
+        uint64_t frequency(string_view word) const
+        {
+            uint64_t wordHash = hash(word);
+            size_t mask = slots.size() - 1;
+            for (size_t i = wordHash & mask; slots[i].count != 0; i = (i + 1) & mask)
+            {
+                if (slots[i].hash == wordHash && key(slots[i]) == word)
+                {
+                    return slots[i].count;
+                }
+            }
+            return 0;
+        }
+
+        //The k most frequent words, highest first (ties in alphabetical order), selected with a bounded
+        //min-heap in O(n log k). The views point into the counter and stay valid until the next addWord().
+        vector<WordCount> topK(size_t k) const
+        {
+            auto better = [](const WordCount& a, const WordCount& b)
+            {
+                return a.frequency != b.frequency ? a.frequency > b.frequency : a.word < b.word;
+            };
+            priority_queue<WordCount, vector<WordCount>, decltype(better)> heap(better); //Top is the weakest kept.
+            if (k == 0) return {};
+            for (const Slot& slot : slots)
+            {
+                if (slot.count == 0) continue;
+                WordCount candidate = { key(slot), slot.count };
+                if (heap.size() < k)
+                {
+                    heap.push(candidate);
+                }
+                else if (better(candidate, heap.top()))
+                {
+                    heap.pop();
+                    heap.push(candidate);
+                }
+            }
+            vector<WordCount> result;
+            result.reserve(heap.size());
+            while (!heap.empty())
+            {
+                result.push_back(heap.top());
+                heap.pop();
+            }
+            reverse(result.begin(), result.end());
+            return result;
+        }
+
+        //Number of distinct words.
+        size_t size() const
+        {
+            return used;
+        }
+
+        //Number of words added, counting repeats.
+        uint64_t totalCount() const
+        {
+            return total;
+        }
+
+        void clear()
+        {
+            fill(slots.begin(), slots.end(), Slot());
+            arena.clear();
+            used = 0;
+            total = 0;
+        }
+
+    private:
+        struct Slot
+        {
+            uint64_t hash = 0;
+            uint32_t offset = 0;
+            uint32_t length = 0;
+            uint64_t count = 0; //0 marks an empty slot.
+        };
+
+        vector<Slot> slots;
+        vector<char> arena;
+        size_t used = 0;
+        uint64_t total = 0;
+
+        string_view key(const Slot& slot) const
+        {
+            return string_view(arena.data() + slot.offset, slot.length);
+        }
+
+        void grow()
+        {
+            vector<Slot> old(slots.size() * 2);
+            old.swap(slots);
+            size_t mask = slots.size() - 1;
+            for (const Slot& slot : old)
+            {
+                if (slot.count == 0) continue;
+                size_t i = slot.hash & mask;
+                while (slots[i].count != 0) i = (i + 1) & mask;
+                slots[i] = slot;
+            }
+        }
+};
+
+#endif